@@ -13,6 +13,7 @@ void ActiveIndicator::load(std::string f) {
 	ArgbSurface *s = Png::load(f);
 	sizeMap = new ArgbSurfaceSizeMap(s);
 	delete s;
+	file = f;
 }
 
 /**
@@ -60,4 +61,5 @@ void ActiveIndicator::reset() {
 void ActiveIndicator::clear() {
 	delete sizeMap;
 	sizeMap = 0;
+	file.clear();
 }
@@ -3,6 +3,8 @@
 
 #include "ArgbSurfaceSizeMap.h"
 
+#include <string>
+
 namespace PieDock {
 class ActiveIndicator {
 public:
@@ -15,6 +17,16 @@ public:
 	inline ArgbSurfaceSizeMap *getSizeMap() const {
 		return sizeMap;
 	}
+	inline const std::string &getFile() const {
+		return file;
+	}
+	inline int getAlignment() const {
+		return xAlign << 8 | yAlign;
+	}
+	inline void setAlignment(int a) {
+		xAlign = static_cast<Alignment>(a >> 8 & 0xff);
+		yAlign = static_cast<Alignment>(a & 0xff);
+	}
 	inline const int getX(int s, int i) const {
 		switch (xAlign) {
 		default:
@@ -52,6 +64,7 @@ private:
 	};
 
 	ArgbSurfaceSizeMap *sizeMap;
+	std::string file;
 	Alignment xAlign;
 	Alignment yAlign;
 
@@ -1,22 +1,33 @@
 #include "Application.h"
 #include "Settings.h"
 #include "PieMenuWindow.h"
+#include "WindowPool.h"
+#include "WindowManager.h"
+#include "WorkspaceLayout.h"
+#include "FrameScheduler.h"
+#include "ControlClient.h"
+#include "Timings.h"
+#include "RequestCounter.h"
+#include "Trace.h"
+#include "Statistics.h"
+#include "Cartouche.h"
 #include "ErrnoException.h"
 
 #include <sys/stat.h>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <sys/wait.h>
 #include <libgen.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <math.h>
 
+#include <iostream>
 #include <sstream>
 
 using namespace PieDock;
 
-const char Application::StopMarker = '\n';
-const char *Application::Show = "show";
-
 /**
  * Initialize application
  *
@@ -24,22 +35,36 @@ const char *Application::Show = "show";
  */
 Application::Application(Settings &s) :
 		display(XOpenDisplay(0)),
+		clientMap(display),
 		root(DefaultRootWindow(display)),
+		grabs(display, root),
 		settings(&s),
-		suspend(StandBy) {
+		ownSettings(0),
+		state(StandBy),
+		controlSocket(-1),
+		stopped(false),
+		reloadPending(false),
+		redraw(false),
+		prewarmPending(false),
+		prewarmAt(0),
+		triggerAt(0),
+		loop(0),
+		frames(0),
+		windows(0),
+		window(0),
+		workspaceLayout(0) {
 	if (!display) {
 		throw std::runtime_error("cannot open display");
 	}
 
-	socketFile =
-		s.getConfigurationFile() +
-		std::string("-socket");
+	socketFile = ControlClient::getSocketFile(s.getConfigurationFile());
 }
 
 /**
  * Clean up
  */
 Application::~Application() {
+	delete ownSettings;
 	XCloseDisplay(display);
 }
 
@@ -50,69 +75,13 @@ Application::~Application() {
  * @param menu - name of menu to open
  */
 bool Application::remote(const char *menu) const {
-	struct stat buf;
-
-	if (stat(socketFile.c_str(), &buf) < 0) {
-		return false;
-	}
-
-	struct sockaddr_un address;
-	int s;
-
-	if ((s = socket(PF_UNIX, SOCK_DGRAM, 0)) < 0) {
-		throw ErrnoException();
-	}
-
-	memset(&address, 0, sizeof(struct sockaddr_un));
-
-	address.sun_family = AF_LOCAL;
-	strncpy(
-		reinterpret_cast<char *>(address.sun_path),
-		socketFile.c_str(),
-		UnixPathMax);
-
-	if (connect(s,
-			(struct sockaddr *) &address,
-			sizeof(struct sockaddr_un)) < 0) {
-		// if there's no listener assume the file has been left
-		// over from a previous instance and try to remove it
-		// to start anew
-		if (errno != ECONNREFUSED || unlink(socketFile.c_str())) {
-			throw ErrnoException();
-		}
-
-		return false;
-	}
-
-	// send command
-	{
-		std::string cmd = Show;
-
-		if (menu) {
-			cmd += std::string(" ") + menu;
-		}
-
-		cmd += StopMarker;
-
-		if (send(s, cmd.c_str(), cmd.size(), 0) < 0) {
-			throw ErrnoException();
-		}
-
-		close(s);
-	}
-
-	return true;
+	return ControlClient(settings->getConfigurationFile()).show(menu);
 }
 
 /**
  * Run application
- *
- * @param stopFlag - pointer to stop flag
  */
-int Application::run(bool *stopFlag) {
-	int xfd = ConnectionNumber(display);
-	int s = 0;
-
+int Application::run() {
 	// at first, load settings
 	settings->load(display);
 
@@ -120,7 +89,7 @@ int Application::run(bool *stopFlag) {
 	{
 		struct sockaddr_un address;
 
-		if ((s = socket(PF_UNIX, SOCK_DGRAM, 0)) < 0) {
+		if ((controlSocket = socket(PF_UNIX, SOCK_DGRAM, 0)) < 0) {
 			throw ErrnoException();
 		}
 
@@ -130,265 +99,630 @@ int Application::run(bool *stopFlag) {
 		strncpy(
 			reinterpret_cast<char *>(address.sun_path),
 			socketFile.c_str(),
-			UnixPathMax);
+			sizeof(address.sun_path) - 1);
 
-		if (bind(s,
+		if (bind(controlSocket,
 				(struct sockaddr *) &address,
 				sizeof(struct sockaddr_un)) < 0) {
 			throw ErrnoException();
 		}
 	}
 
-	grabTriggers();
+	// get notified about reparenting and destruction of top level
+	// windows, about changes of the client list and about workspace
+	// changes to keep cached window information valid
+	XSelectInput(
+		display,
+		root,
+		SubstructureNotifyMask |
+		StructureNotifyMask |
+		PropertyChangeMask);
+
+	workspaceLayout = WorkspaceLayout::getWorkspaceLayout(
+		display,
+		settings->getWorkspaceDisplaySettings().preferredLayout);
+
+	grabs.update(*settings);
+
+	EventLoop l;
+	FrameScheduler f(settings->getFps());
+	WindowPool p(*this);
+
+	// every menu gets its own window with its own caches
+	p.fill();
+
+	loop = &l;
+	frames = &f;
+	windows = &p;
+
+	l.add(ConnectionNumber(display), this);
+	l.add(controlSocket, this);
+	l.addSignal(SIGCHLD, this);
+	l.addSignal(SIGHUP, this);
+	l.addSignal(SIGINT, this);
+	l.addSignal(SIGTERM, this);
+
+	// icons for the first frame of every menu are resized before
+	// the first menu is shown; after that menus are brought up to
+	// date while standing by at the latest PrewarmDelay after the
+	// first of a burst of window changes
+	prewarm();
+
+	while (!stopped) {
+		// process all queued events first; the menu is redrawn once
+		// after that, so a burst of motion events results in a
+		// single frame
+		while (!stopped && XPending(display)) {
+			XEvent event;
+
+			bzero(&event, sizeof(event));
+			XNextEvent(display, &event);
+
+			processEvent(event);
+		}
 
-	for (PieMenuWindow w(*this); !*stopFlag;) {
-		if (!XPending(display)) {
-			fd_set rfds;
-			struct timeval tv, *ptv = 0;
+		if (stopped) {
+			break;
+		}
 
-			FD_ZERO(&rfds);
-			FD_SET(xfd, &rfds);
-			FD_SET(s, &rfds);
+		if (state == Active && redraw) {
+			window->draw();
+			redraw = false;
 
-			if (suspend > 0) {
-				tv.tv_sec = 0;
-				tv.tv_usec = suspend;
-				ptv = &tv;
-			}
+			// time from trigger to the first frame; wait until the
+			// server has processed it, this happens once per open
+			if (triggerAt > 0) {
+				RequestCounter::roundTrip();
+				XSync(display, False);
+
+				double duration = FrameScheduler::now() - triggerAt;
 
-			// wait for descriptors to become readable
-			{
-				int highest = (s > xfd ? s : xfd) + 1;
-				int hits;
-
-				if ((hits = select(highest, &rfds, 0, 0, ptv)) < 0) {
-					// signal caught
-					if (errno == EINTR) {
-						continue;
-					}
-
-					// some descriptor has been closed
-					break;
-				} else if (!hits) {
-					// timeout
-					if (suspend == Active) {
-						w.draw();
-					}
-
-					continue;
-				} else {
-					// some descriptor has become readable
-					if (FD_ISSET(s, &rfds)) {
-						std::string message;
-
-						// read from socket, don't do that byte by byte
-						// as you would do with a network socket, file
-						// sockets will block after a recv() no matter
-						// how many bytes recv requested from the buffer
-						{
-							char m[0xff];
-
-							bzero(m, sizeof(m));
-
-							if ((recv(s, m, sizeof(m), 0)) < 0) {
-								continue;
-							}
-
-							message = m;
-						}
-
-						if (!message.find(Show) && suspend == StandBy) {
-							std::string menuName = "";
-
-							// get menu name
-							{
-								std::string::size_type p;
-
-								if ((p = message.find(StopMarker)) !=
-										std::string::npos) {
-									message.erase(p);
-								}
-
-								if ((p = message.find(' ')) !=
-										std::string::npos) {
-									menuName = message.substr(++p);
-								}
-							}
-
-							// why? see below
-							ungrabTriggers();
-
-							if (w.appear(
-									menuName,
-									PieMenuWindow::AroundCursor)) {
-								suspend = Active;
-							} else {
-								grabTriggers();
-							}
-						}
-					}
-
-					if (!FD_ISSET(xfd, &rfds)) {
-						continue;
-					}
+				Timings::record(Timings::Trigger, duration);
+
+				if (Trace::isEnabled()) {
+					Trace::add(
+						Timings::getName(Timings::Trigger),
+						triggerAt,
+						duration);
 				}
+
+				triggerAt = 0;
 			}
 		}
 
-		XEvent event;
-
-		bzero(&event, sizeof(event));
-		XNextEvent(display, &event);
-
-		if (suspend == StandBy &&
-				event.xany.window == root &&
-				(event.type == ButtonPress ||
-					event.type == ButtonRelease ||
-					event.type == KeyPress)) {
-			// valid? read below, see button event masks
-			bool valid = false;
-
-			// find menu name from trigger
-			std::string menuName = "";
-
-			if (event.type == KeyPress) {
-				for (Settings::Keys::iterator i = settings->getKeys().begin();
-						i != settings->getKeys().end();
-						++i) {
-					if (XKeysymToKeycode(event.xany.display, (*i).keySym) ==
-							event.xkey.keycode &&
-							(
-								// AnyModifier (32768 in X.h) cannot be used
-								// for binary operations
-								(*i).modifier == AnyModifier ||
-								((*i).modifier & event.xkey.state)
-							)) {
-						valid = true;
-						menuName = (*i).menuName;
-						break;
-					}
-				}
-			} else {
-				for (Settings::Buttons::iterator i =
-							settings->getButtons().begin();
-						i != settings->getButtons().end();
-						++i) {
-					if ((*i).button == event.xbutton.button &&
-							(
-								// AnyModifier (32768 in X.h) cannot be used
-								// for binary operations
-								(*i).modifier == AnyModifier ||
-								((*i).modifier & event.xbutton.state)
-							) &&
-							// on some implementations of X, for example
-							// X.Org X 1.6.3.901 (1.6.4 RC1) 64bit, we receive
-							// ButtonPress events even when XGrabButton had only
-							// ButtonReleaseMask selected which causes all
-							// menus to appear on a button press;
-							// hence the "valid" flag
-							(
-								((*i).eventMask == ButtonPressMask &&
-									event.type == ButtonPress) ||
-								((*i).eventMask == ButtonReleaseMask &&
-									event.type == ButtonRelease)
-							)) {
-						valid = true;
-						menuName = (*i).menuName;
-						break;
-					}
+		// only animations need frames, everything else is
+		// driven by events
+		if (state == Active && window->isAnimating()) {
+			if (!f.isRunning()) {
+				f.start();
+
+				if (f.getDescriptor() > -1) {
+					l.add(f.getDescriptor(), this);
 				}
 			}
+		} else if (f.isRunning()) {
+			if (f.getDescriptor() > -1) {
+				l.remove(f.getDescriptor());
+			}
 
-			if (valid) {
-				// ungrab triggers to avoid being triggered again while
-				// already being visible; since receiving a new trigger
-				// event will be preceded by a LeaveWindowEvent in
-				// PieMenuWindow which will cause the menu to disappear
-				// again, it's best to simply ungrab the triggers
-				ungrabTriggers();
-
-				if (w.appear(
-						menuName,
-						(event.type == KeyPress ?
-							PieMenuWindow::IconBelowCursor :
-							PieMenuWindow::AroundCursor))) {
-					suspend = Active;
-				} else {
-					grabTriggers();
-				}
+			f.stop();
+		}
+
+		if (state == StandBy && reloadPending) {
+			try {
+				reload();
+			} catch (std::exception &e) {
+				reloadPending = false;
+				std::cerr << "error: cannot reload: " <<
+					e.what() << std::endl;
 			}
-		} else if (suspend == Active && !w.processEvent(event)) {
-			suspend = StandBy;
-			grabTriggers();
+			continue;
+		}
+
+		if (state == StandBy &&
+				prewarmPending &&
+				FrameScheduler::now() >= prewarmAt) {
+			prewarm();
+			continue;
+		}
+
+		// XPending() flushed before the last draw() so make sure
+		// its requests reach the server before blocking
+		XFlush(display);
+
+		l.wait(getTimeout());
+
+		// without a descriptor frames are paced by the timeout
+		if (f.isRunning() &&
+				f.getDescriptor() < 0 &&
+				f.isDue()) {
+			f.tick();
+			window->draw();
 		}
 	}
 
-	ungrabTriggers();
-	close(s);
+	if (f.isRunning() && f.getDescriptor() > -1) {
+		l.remove(f.getDescriptor());
+	}
+
+	loop = 0;
+	frames = 0;
+	windows = 0;
+	window = 0;
+
+	grabs.clear();
+	close(controlSocket);
 	unlink(socketFile.c_str());
 
 	return 0;
 }
 
 /**
- * Grab triggers
+ * Handle readable descriptor
+ *
+ * @param fd - file descriptor
  */
-void Application::grabTriggers() {
-	// buttons
-	for (Settings::Buttons::iterator i = settings->getButtons().begin();
-			i != settings->getButtons().end();
-			++i) {
-		XGrabButton(
-			display,
-			(*i).button,
-			(*i).modifier,
-			root,
-			True,
-			(*i).eventMask,
-			GrabModeAsync,
-			GrabModeAsync,
-			None,
-			None);
+void Application::handleDescriptor(int fd) {
+	if (fd == controlSocket) {
+		// read from socket, don't do that byte by byte
+		// as you would do with a network socket, file
+		// sockets will block after a recv() no matter
+		// how many bytes recv requested from the buffer
+		char m[ControlClient::MaximumMessage];
+		struct sockaddr_un from;
+		socklen_t fromLength = sizeof(from);
+		ssize_t n;
+
+		if ((n = recvfrom(
+				controlSocket,
+				m,
+				sizeof(m),
+				0,
+				(struct sockaddr *) &from,
+				&fromLength)) < 0) {
+			return;
+		}
+
+		std::string reply = processMessage(std::string(m, n));
+
+		// clients that didn't bind to an address don't want a reply
+		if (fromLength > sizeof(sa_family_t)) {
+			sendto(
+				controlSocket,
+				reply.c_str(),
+				reply.size(),
+				MSG_DONTWAIT,
+				(struct sockaddr *) &from,
+				fromLength);
+		}
+	} else if (frames && fd == frames->getDescriptor()) {
+		frames->tick();
+		window->draw();
 	}
 
-	// keys
-	for (Settings::Keys::iterator i = settings->getKeys().begin();
-			i != settings->getKeys().end();
-			++i) {
-		XGrabKey(
-			display,
-			XKeysymToKeycode(display, (*i).keySym),
-			(*i).modifier,
-			root,
-			True,
-			GrabModeAsync,
-			GrabModeAsync);
+	// X events are read in run()
+}
+
+/**
+ * Handle signal
+ *
+ * @param signo - signal number
+ */
+void Application::handleSignal(int signo) {
+	switch (signo) {
+	case SIGCHLD:
+		// more than one process may have been terminated
+		while (waitpid(-1, 0, WNOHANG | WUNTRACED) > 0);
+		break;
+	case SIGHUP:
+		// reload when standing by
+		reloadPending = true;
+		break;
+	case SIGINT:
+	case SIGTERM:
+		stopped = true;
+		break;
 	}
 }
 
 /**
- * Ungrab triggers
+ * Process message from control socket; a message may contain any number
+ * of commands, one per line, and the reply contains the output of each
+ * command terminated by a line reading either "ok" or "error" followed
+ * by a reason
+ *
+ * @param message - message
  */
-void Application::ungrabTriggers() {
-	// buttons
-	for (Settings::Buttons::iterator i = settings->getButtons().begin();
-			i != settings->getButtons().end();
-			++i) {
-		XUngrabButton(
-			display,
-			(*i).button,
-			(*i).modifier,
-			root);
+std::string Application::processMessage(const std::string &message) {
+	std::ostringstream reply;
+
+	for (std::string::size_type p = 0, e;
+			p < message.size();
+			p = e+1) {
+		if ((e = message.find(ControlClient::StopMarker, p)) ==
+				std::string::npos) {
+			e = message.size();
+		}
+
+		std::string command = message.substr(p, e-p);
+
+		if (command.empty()) {
+			continue;
+		}
+
+		try {
+			processCommand(command, reply);
+		} catch (std::exception &ex) {
+			reply << "error " << ex.what() << ControlClient::StopMarker;
+		}
 	}
 
-	// keys
-	for (Settings::Keys::iterator i = settings->getKeys().begin();
-			i != settings->getKeys().end();
-			++i) {
-		XUngrabKey(
-			display,
-			XKeysymToKeycode(display, (*i).keySym),
-			(*i).modifier,
-			root);
+	return reply.str();
+}
+
+/**
+ * Process a single command from control socket
+ *
+ * @param command - command and optional argument
+ * @param reply - stream to write the reply to
+ */
+void Application::processCommand(
+	const std::string &command,
+	std::ostream &reply) {
+	std::string name = command;
+	std::string argument;
+
+	{
+		std::string::size_type p;
+
+		if ((p = command.find(' ')) != std::string::npos) {
+			name = command.substr(0, p);
+			argument = command.substr(p+1);
+		}
 	}
+
+	if (!name.compare("ping")) {
+		reply << "piedock " << ControlClient::ProtocolVersion <<
+			ControlClient::StopMarker;
+	} else if (!name.compare("version")) {
+		if (atoi(argument.c_str()) > ControlClient::ProtocolVersion) {
+			throw std::runtime_error("unsupported protocol version");
+		}
+	} else if (!name.compare("stats")) {
+		const char nl = ControlClient::StopMarker;
+		Settings::Menus *menus = &settings->getMenus();
+		int items = 0;
+
+		for (Settings::Menus::iterator i = menus->begin();
+				i != menus->end();
+				++i) {
+			items += (*i).second.size();
+		}
+
+		reply <<
+			"state " << (state == Active ? "active" : "standby") << nl <<
+			"menus " << menus->size() << nl <<
+			"items " << items << nl <<
+			"windows " << windows->getNumberOfWindows() << nl <<
+			"clients " << clientMap.getNumberOfClients() << nl <<
+			"client_serial " << clientMap.getSerial() << nl <<
+			"icons " << settings->getIconMap().getNumberOfIcons() << nl <<
+			"icon_sizes " << settings->getIconMap().getNumberOfSizes() << nl;
+	} else if (!name.compare("metrics")) {
+		Statistics s;
+		Statistics::Usage icons = { 0, 0, 0, 0 };
+		Statistics::Usage sizes = icons;
+		Statistics::Usage indicator = icons;
+		Statistics::Usage titles = icons;
+		Statistics::Usage corners = icons;
+
+		settings->getIconMap().addUsage(icons, sizes);
+
+		if (settings->getActiveIndicator().getSizeMap()) {
+			settings->getActiveIndicator().getSizeMap()->addUsage(
+				indicator);
+		}
+
+		windows->addTitlesUsage(titles);
+		Cartouche::addCornersUsage(corners);
+
+		s.add("icons", icons);
+		s.add("icon_sizes", sizes);
+		s.add("indicator_sizes", indicator);
+		s.add("titles", titles);
+		s.add("cartouche_corners", corners);
+		s.write(reply, ControlClient::StopMarker);
+	} else if (!name.compare("timings")) {
+		if (!argument.compare("reset")) {
+			Timings::reset();
+		} else {
+			Timings::report(reply, ControlClient::StopMarker);
+		}
+	} else if (state != StandBy) {
+		// everything below changes menus and must not happen
+		// while a menu is shown
+		throw std::runtime_error("busy");
+	} else if (!name.compare(ControlClient::Show)) {
+		if (!show(argument, false)) {
+			throw std::runtime_error("nothing to show");
+		}
+	} else if (!name.compare("prewarm")) {
+		if (command.size() > name.size()) {
+			if (!windows->prewarm(argument)) {
+				throw std::runtime_error("no such menu");
+			}
+		} else {
+			prewarm();
+		}
+	} else if (!name.compare("flush")) {
+		flush();
+	} else if (!name.compare("reload")) {
+		unsigned int changes = reload();
+
+		reply << "changed" <<
+			(changes & Settings::WindowChanges ? " windows" : "") <<
+			(changes & Settings::IconChanges ? " icons" : "") <<
+			(changes & Settings::MenuChanges ? " menus" : "") <<
+			(changes & Settings::TriggerChanges ? " triggers" : "") <<
+			ControlClient::StopMarker;
+	} else {
+		throw std::runtime_error("unknown command");
+	}
+
+	reply << "ok" << ControlClient::StopMarker;
+}
+
+/**
+ * Process X event
+ *
+ * @param event - X event
+ */
+void Application::processEvent(XEvent &event) {
+	switch (event.type) {
+	case MappingNotify:
+		if (event.xmapping.request == MappingPointer) {
+			return;
+		}
+
+		// triggers need to be grabbed again with the new key codes
+		XRefreshKeyboardMapping(&event.xmapping);
+		settings->updateDispatchTables(display);
+		grabs.update(*settings);
+		return;
+	case ReparentNotify:
+		WindowManager::forgetClientWindow(event.xreparent.window);
+		WindowManager::forgetClientWindow(event.xreparent.parent);
+		return;
+	case DestroyNotify:
+		WindowManager::forgetClientWindow(event.xdestroywindow.window);
+		return;
+	case ConfigureNotify:
+	case PropertyNotify:
+	case MapNotify:
+	case UnmapNotify:
+		if (workspaceLayout->processEvent(event) ||
+				clientMap.processEvent(event)) {
+			if (settings->isPrewarm() && !prewarmPending) {
+				prewarmAt = FrameScheduler::now() +
+					static_cast<double>(PrewarmDelay) / 1000.0;
+				prewarmPending = true;
+			}
+
+			return;
+		}
+		break;
+	}
+
+	if (state == StandBy &&
+			event.xany.window == root &&
+			(event.type == ButtonPress ||
+				event.type == ButtonRelease ||
+				event.type == KeyPress)) {
+		const Settings::Trigger *t = event.type == KeyPress ?
+			settings->getKeyTrigger(
+				event.xkey.keycode,
+				event.xkey.state) :
+			settings->getButtonTrigger(
+				event.xbutton.button,
+				event.type,
+				event.xbutton.state);
+
+		if (t) {
+			show(t->menuName, event.type == KeyPress);
+		}
+	} else if (state == Active) {
+		if (!window->processEvent(event)) {
+			state = StandBy;
+			closed();
+		} else {
+			redraw = true;
+		}
+	}
+}
+
+/**
+ * Conclude request counts of the menu that has just been closed
+ */
+void Application::closed() {
+	RequestCounter::endOpen(display);
+
+	if (!Trace::isEnabled()) {
+		return;
+	}
+
+	double now = FrameScheduler::now();
+
+	for (int i = 0; i < RequestCounter::NumberOfPhases; ++i) {
+		RequestCounter::Phase p = static_cast<RequestCounter::Phase>(i);
+		std::string name = RequestCounter::getName(p);
+
+		Trace::addCounter(
+			(name + "_requests").c_str(),
+			now,
+			RequestCounter::getLastRequests(p));
+		Trace::addCounter(
+			(name + "_round_trips").c_str(),
+			now,
+			RequestCounter::getLastRoundTrips(p));
+	}
+}
+
+/**
+ * Show menu, returns false if there are no menu items
+ *
+ * @param menuName - menu name
+ * @param iconBelowCursor - true to place the active icon below the
+ *                          cursor instead of the center of the menu
+ */
+bool Application::show(std::string menuName, bool iconBelowCursor) {
+	Timings::Span span(Timings::Show);
+	double start = FrameScheduler::now();
+
+	RequestCounter::beginOpen(display);
+
+	// triggers stay grabbed while the menu is visible; trigger
+	// events are simply not evaluated in Active state and
+	// PieMenuWindow ignores the crossing events caused by
+	// activating a passive grab
+	PieMenuWindow *w = windows->getWindow(menuName);
+
+	if (!w->appear(
+			menuName,
+			(iconBelowCursor ?
+				PieMenuWindow::IconBelowCursor :
+				PieMenuWindow::AroundCursor))) {
+		return false;
+	}
+
+	window = w;
+	state = Active;
+	redraw = true;
+	triggerAt = start;
+
+	return true;
+}
+
+/**
+ * Bring all menus up to date
+ */
+void Application::prewarm() {
+	Timings::Span span(Timings::Prewarm);
+
+	windows->prewarm();
+	prewarmPending = false;
+}
+
+/**
+ * Read configuration file again and only drop what has changed; returns
+ * a bit mask of Settings::Changes
+ */
+unsigned int Application::reload() {
+	Settings *fresh = new Settings();
+
+	fresh->setConfigurationFile(settings->getConfigurationFile());
+
+	// keep the current settings if the file can't be parsed
+	try {
+		fresh->read(display);
+	} catch (...) {
+		delete fresh;
+		throw;
+	}
+
+	unsigned int changes = fresh->compare(*settings);
+
+	// windows depend on size and appearance settings and keep
+	// icons of open windows
+	if (changes & (Settings::WindowChanges | Settings::IconChanges)) {
+		windows->clear();
+	} else {
+		windows->forgetMenuItems();
+	}
+
+	window = 0;
+
+	// decoded and resized icons stay valid if icons are
+	// looked up the same way
+	if (!(changes & Settings::IconChanges)) {
+		fresh->adoptIcons(*settings);
+	}
+
+	// the initial settings belong to the caller and can only be
+	// emptied
+	if (ownSettings) {
+		delete ownSettings;
+	} else {
+		settings->reset();
+	}
+
+	settings = ownSettings = fresh;
+	reloadPending = false;
+
+	workspaceLayout->setPreferredLayout(
+		settings->getWorkspaceDisplaySettings().preferredLayout);
+	grabs.update(*settings);
+	frames->setRate(settings->getFps());
+
+	// kept windows of menus that are gone would never be shown again
+	if (changes & (Settings::MenuChanges | Settings::TriggerChanges)) {
+		windows->prune();
+	}
+
+	windows->fill();
+
+	prewarmPending = settings->isPrewarm();
+	prewarmAt = FrameScheduler::now();
+
+	settings->preloadIcons();
+
+	return changes;
+}
+
+/**
+ * Drop all caches that can be rebuilt; this recreates all windows
+ */
+void Application::flush() {
+	windows->clear();
+	window = 0;
+
+	settings->getIconMap().flushSizes();
+
+	if (settings->getActiveIndicator().getSizeMap()) {
+		settings->getActiveIndicator().getSizeMap()->clear();
+	}
+
+	clientMap.invalidate();
+	WindowManager::forgetClientWindows();
+
+	windows->fill();
+
+	prewarmPending = settings->isPrewarm();
+	prewarmAt = FrameScheduler::now();
+}
+
+/**
+ * Return how long the event loop may wait in milliseconds or -1 if it
+ * may wait until a descriptor becomes readable
+ */
+int Application::getTimeout() const {
+	int timeout = -1;
+
+	if (frames->isRunning() && frames->getDescriptor() < 0) {
+		timeout = frames->getTimeout();
+	}
+
+	if (state == StandBy && prewarmPending) {
+		int t = static_cast<int>(
+			ceil((prewarmAt - FrameScheduler::now()) * 1000.0));
+
+		if (t < 0) {
+			t = 0;
+		}
+
+		if (timeout < 0 || t < timeout) {
+			timeout = t;
+		}
+	}
+
+	return timeout;
 }
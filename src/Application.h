@@ -3,11 +3,23 @@
 
 #include <X11/Xlib.h>
 #include <string>
+#include <ostream>
 
 #include "Settings.h"
+#include "ClientMap.h"
+#include "EventLoop.h"
+#include "TriggerGrabs.h"
 
 namespace PieDock {
-class Application {
+// forward declarations
+class FrameScheduler;
+class PieMenuWindow;
+class WindowPool;
+class WorkspaceLayout;
+
+class Application :
+	public EventLoop::Handler,
+	public EventLoop::SignalHandler {
 public:
 	Application(Settings &);
 	virtual ~Application();
@@ -17,31 +29,62 @@ public:
 	inline Settings *getSettings() {
 		return settings;
 	}
+	inline ClientMap &getClientMap() {
+		return clientMap;
+	}
+
+	inline EventLoop *getEventLoop() const {
+		return loop;
+	}
+	inline WindowPool *getWindowPool() const {
+		return windows;
+	}
 
 	bool remote(const char * = 0) const;
-	int run(bool *);
+	int run();
+	virtual void handleDescriptor(int);
+	virtual void handleSignal(int);
 
 private:
-	static const char StopMarker;
-	static const char *Show;
-
-	enum PulseBeats {
-		StandBy = 0,
-		Active = 10000
+	enum State {
+		StandBy,
+		Active
 	};
 
 	enum {
-		UnixPathMax = 108
+		PrewarmDelay = 250
 	};
 
 	Display *display;
+	ClientMap clientMap;
 	Window root;
+	TriggerGrabs grabs;
 	Settings *settings;
-	int suspend;
+	Settings *ownSettings;
+	State state;
 	std::string socketFile;
+	int controlSocket;
+	bool stopped;
+	bool reloadPending;
+	bool redraw;
+	bool prewarmPending;
+	double prewarmAt;
+	double triggerAt;
+	EventLoop *loop;
+	FrameScheduler *frames;
+	WindowPool *windows;
+	PieMenuWindow *window;
+	WorkspaceLayout *workspaceLayout;
 
-	void grabTriggers();
-	void ungrabTriggers();
+	std::string processMessage(const std::string &);
+	void processCommand(const std::string &, std::ostream &);
+	void processEvent(XEvent &);
+	bool show(std::string, bool);
+	void closed();
+	void prewarm();
+	unsigned int reload();
+	void flush();
+	int getTimeout() const;
 };
 }
 
@@ -1,5 +1,6 @@
 #include "ArgbSurfaceSizeMap.h"
 #include "Resampler.h"
+#include "Timings.h"
 
 using namespace PieDock;
 
@@ -9,7 +10,9 @@ using namespace PieDock;
  * @param s - some ARGB surface
  */
 ArgbSurfaceSizeMap::ArgbSurfaceSizeMap(const ArgbSurface *s) :
-	surface(*s) {
+	surface(*s),
+	hits(0),
+	misses(0) {
 }
 
 /**
@@ -28,6 +31,7 @@ ArgbSurfaceSizeMap::~ArgbSurfaceSizeMap() {
 const ArgbSurface *ArgbSurfaceSizeMap::getSurface(int width, int height) {
 	if (width == surface.getWidth() &&
 			height == surface.getHeight()) {
+		++hits;
 		return &surface;
 	}
 
@@ -35,17 +39,39 @@ const ArgbSurface *ArgbSurfaceSizeMap::getSurface(int width, int height) {
 	SurfaceMap::iterator i;
 
 	if ((i = surfaceMap.find(format)) == surfaceMap.end()) {
+		Timings::Span span(Timings::Resample, width);
 		ArgbSurface *s = new ArgbSurface(width, height);
 
+		++misses;
+
 		Resampler::resample(*s, surface);
 		surfaceMap.insert(std::make_pair(format, s));
 
 		return s;
 	}
 
+	++hits;
+
 	return (*i).second;
 }
 
+/**
+ * Add number, size and look ups of resized surfaces to usage
+ *
+ * @param u - usage
+ */
+void ArgbSurfaceSizeMap::addUsage(Statistics::Usage &u) const {
+	for (SurfaceMap::const_iterator i = surfaceMap.begin();
+			i != surfaceMap.end();
+			++i) {
+		u.bytes += (*i).second->getSize();
+	}
+
+	u.entries += surfaceMap.size();
+	u.hits += hits;
+	u.misses += misses;
+}
+
 /**
  * Reset surface
  *
@@ -2,6 +2,7 @@
 #define _PieDock_ArgbSurfaceSizeMap_
 
 #include "ArgbSurface.h"
+#include "Statistics.h"
 
 #include <string>
 #include <map>
@@ -14,17 +15,21 @@ public:
 	inline const ArgbSurface &getSurface() const {
 		return surface;
 	}
+	inline int getNumberOfSizes() const {
+		return surfaceMap.size();
+	}
 	virtual const ArgbSurface *getSurface(int, int);
 	virtual void setSurface(ArgbSurface *);
-
-protected:
 	virtual void clear();
+	virtual void addUsage(Statistics::Usage &) const;
 
 private:
 	typedef std::map<int, ArgbSurface *> SurfaceMap;
 
 	ArgbSurface surface;
 	SurfaceMap surfaceMap;
+	unsigned long hits;
+	unsigned long misses;
 };
 }
 
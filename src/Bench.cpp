@@ -0,0 +1,175 @@
+#include "Bench.h"
+#include "Png.h"
+#include "Timings.h"
+#include "FrameScheduler.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+
+using namespace PieDock;
+
+/**
+ * Set up a menu with synthetic icons that is drawn into plain memory;
+ * nothing here needs a connection to the X server
+ *
+ * @param s - settings
+ * @param depth - color depth of canvas (optional)
+ */
+Bench::Bench(Settings &s, int depth) :
+	canvas(s.getWidth(), s.getHeight(), depth),
+	menu(0, canvas, &s) {
+	for (int n = 0; n < NumberOfItems; ++n) {
+		ArgbSurface *surface = createIcon(n);
+
+		menuItems.push_back(new MenuItem(new Icon(surface)));
+		delete surface;
+	}
+
+	menu.setMenuItems(&menuItems);
+}
+
+/**
+ * Clean up
+ */
+Bench::~Bench() {
+	menu.forgetMenuItems();
+
+	for (MenuItems::iterator i = menuItems.begin();
+			i != menuItems.end();
+			++i) {
+		delete (*i)->getIcon();
+		delete *i;
+	}
+}
+
+/**
+ * Draw the same sequence of frames on every run; animations advance
+ * by a fixed time step instead of the clock so every frame shows the
+ * same picture no matter how long drawing takes
+ *
+ * @param out - output stream for results
+ * @param directory - directory to write frames to as PNG (optional)
+ */
+void Bench::run(std::ostream &out, const std::string &directory) {
+	double total = 0;
+
+	Timings::reset();
+	menu.restart();
+
+	for (int frame = 0; frame < NumberOfFrames; ++frame) {
+		int x;
+		int y;
+
+		getCursor(frame, x, y);
+
+		{
+			double start = FrameScheduler::now();
+
+			Trace::nextFrame();
+			Timings::Span span(Timings::Frame);
+
+			canvas.clear();
+			menu.animate(static_cast<double>(frame) / FramesPerSecond);
+			menu.draw(x, y);
+
+			total += FrameScheduler::now() - start;
+		}
+
+		if (!directory.empty()) {
+			char file[16];
+			ArgbSurface *argb = canvas.getArgbSurface();
+
+			snprintf(file, sizeof(file), "/%04d.png", frame);
+
+			try {
+				Png::save(directory + file, argb);
+			} catch (...) {
+				delete argb;
+				throw;
+			}
+
+			delete argb;
+		}
+	}
+
+	out << "frames " << NumberOfFrames <<
+		" size " << canvas.getWidth() << "x" << canvas.getHeight() <<
+		" depth " << canvas.getDepth() <<
+		" total_ms " << total * 1000.0 <<
+		" frame_ms " << total * 1000.0 / NumberOfFrames << std::endl;
+
+	Timings::report(out);
+}
+
+/**
+ * Create a colored disc with a soft edge as icon
+ *
+ * @param n - index of icon, determines its hue
+ */
+ArgbSurface *Bench::createIcon(int n) {
+	ArgbSurface *s = new ArgbSurface(IconSize, IconSize);
+	uint32_t *p = reinterpret_cast<uint32_t *>(s->getData());
+	double hue = 6.0 * n / NumberOfItems;
+	double f = hue - floor(hue);
+	int v[] = {
+		0xff,
+		static_cast<int>(0xff * (1.0 - f)),
+		0,
+		0,
+		static_cast<int>(0xff * f),
+		0xff};
+	int sector = static_cast<int>(hue);
+	uint32_t color =
+		v[sector % 6] << 16 |
+		v[(sector + 4) % 6] << 8 |
+		v[(sector + 2) % 6];
+	double center = .5 * IconSize;
+	double radius = center - 1.0;
+
+	for (int y = 0; y < IconSize; ++y) {
+		for (int x = 0; x < IconSize; ++x) {
+			double dx = x + .5 - center;
+			double dy = y + .5 - center;
+			double a = radius - sqrt(dx * dx + dy * dy);
+
+			if (a < 0) {
+				a = 0;
+			} else if (a > 1.0) {
+				a = 1.0;
+			}
+
+			*(p++) = static_cast<uint32_t>(a * 0xff) << 24 | color;
+		}
+	}
+
+	return s;
+}
+
+/**
+ * Return cursor position for a frame; the cursor rests in the center
+ * while the menu zooms in, moves out onto the icons and then circles
+ * once around the menu
+ *
+ * @param frame - frame number
+ * @param x - x coordinate of cursor position within canvas
+ * @param y - y coordinate of cursor position within canvas
+ */
+void Bench::getCursor(int frame, int &x, int &y) const {
+	const int rest = NumberOfFrames / 4;
+	const int move = NumberOfFrames / 4;
+	double r = menu.getRadius();
+	double angle = 0;
+
+	if (frame < rest) {
+		r = 0;
+	} else if (frame < rest + move) {
+		r *= static_cast<double>(frame - rest) / move;
+	} else {
+		angle = 2.0 * M_PI * (frame - rest - move) /
+			(NumberOfFrames - rest - move);
+	}
+
+	x = (canvas.getWidth() >> 1) + static_cast<int>(r * cos(angle));
+	y = (canvas.getHeight() >> 1) + static_cast<int>(r * sin(angle));
+}
@@ -0,0 +1,36 @@
+#ifndef _PieDock_Bench_
+#define _PieDock_Bench_
+
+#include "Settings.h"
+#include "MemorySurface.h"
+#include "MenuItems.h"
+#include "PieMenu.h"
+
+#include <string>
+#include <ostream>
+
+namespace PieDock {
+class Bench {
+public:
+	Bench(Settings &, int = Surface::ARGB);
+	virtual ~Bench();
+	virtual void run(std::ostream &, const std::string & = "");
+
+private:
+	enum {
+		NumberOfItems = 12,
+		NumberOfFrames = 240,
+		FramesPerSecond = 60,
+		IconSize = 128
+	};
+
+	MemorySurface canvas;
+	MenuItems menuItems;
+	PieMenu menu;
+
+	static ArgbSurface *createIcon(int);
+	void getCursor(int, int &, int &) const;
+};
+}
+
+#endif
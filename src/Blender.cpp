@@ -1,4 +1,5 @@
 #include "Blender.h"
+#include "Timings.h"
 
 #include <stdint.h>
 
@@ -23,6 +24,7 @@ Blender::Blender(Surface &c) : canvas(&c) {
  * @param a - alpha value (optional)
  */
 void Blender::blend(const ArgbSurface &src, int x, int y, int a) {
+	Timings::Span span(Timings::Blend, src.getWidth());
 	Details details = {
 		canvas->getData(),
 		src.getData(),
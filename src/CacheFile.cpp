@@ -0,0 +1,180 @@
+#include "CacheFile.h"
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+using namespace PieDock;
+
+/**
+ * Read whole file at once; returns false if the file can't be read
+ *
+ * @param file - path and name of file
+ */
+bool CacheFile::read(const std::string &file) {
+	int fd;
+	struct stat buf;
+
+	data.clear();
+	offset = 0;
+
+	if ((fd = open(file.c_str(), O_RDONLY)) < 0) {
+		return false;
+	}
+
+	if (fstat(fd, &buf) < 0) {
+		close(fd);
+		return false;
+	}
+
+	data.resize(buf.st_size);
+
+	ssize_t n = buf.st_size > 0 ?
+		::read(fd, &data[0], buf.st_size) :
+		0;
+
+	close(fd);
+
+	if (n != buf.st_size) {
+		data.clear();
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Write data to file; the file is replaced atomically so concurrent
+ * readers never see a partial file; returns false on failure
+ *
+ * @param file - path and name of file
+ */
+bool CacheFile::write(const std::string &file) const {
+	char pid[16];
+
+	snprintf(pid, sizeof(pid), ".%d", static_cast<int>(getpid()));
+
+	std::string tmp = file + pid;
+	int fd;
+
+	if ((fd = open(
+			tmp.c_str(),
+			O_WRONLY | O_CREAT | O_TRUNC,
+			S_IRUSR | S_IWUSR)) < 0) {
+		return false;
+	}
+
+	ssize_t n = ::write(fd, data.c_str(), data.size());
+
+	if (close(fd) < 0 ||
+			n != static_cast<ssize_t>(data.size()) ||
+			rename(tmp.c_str(), file.c_str()) < 0) {
+		unlink(tmp.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Append integer
+ *
+ * @param v - value
+ */
+void CacheFile::putInt(int64_t v) {
+	data.append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+/**
+ * Append floating point number
+ *
+ * @param v - value
+ */
+void CacheFile::putDouble(double v) {
+	data.append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+/**
+ * Append string
+ *
+ * @param s - string
+ */
+void CacheFile::putString(const std::string &s) {
+	putInt(s.size());
+	data.append(s);
+}
+
+/**
+ * Read next integer
+ */
+int64_t CacheFile::getInt() {
+	int64_t v;
+
+	get(&v, sizeof(v));
+
+	return v;
+}
+
+/**
+ * Read next floating point number
+ */
+double CacheFile::getDouble() {
+	double v;
+
+	get(&v, sizeof(v));
+
+	return v;
+}
+
+/**
+ * Read next string
+ */
+std::string CacheFile::getString() {
+	int64_t l = getInt();
+
+	if (l < 0 || static_cast<uint64_t>(l) > data.size() - offset) {
+		throw std::runtime_error("corrupt cache file");
+	}
+
+	std::string s = data.substr(offset, l);
+	offset += l;
+
+	return s;
+}
+
+/**
+ * Return FNV-1a hash of some bytes
+ *
+ * @param p - bytes
+ * @param size - number of bytes
+ * @param h - hash to continue (optional)
+ */
+uint64_t CacheFile::hash(const void *p, size_t size, uint64_t h) {
+	const unsigned char *s = static_cast<const unsigned char *>(p);
+
+	for (; size--; ++s) {
+		h ^= *s;
+		h *= 0x100000001b3ULL;
+	}
+
+	return h;
+}
+
+/**
+ * Read next bytes
+ *
+ * @param p - destination
+ * @param size - number of bytes
+ */
+void CacheFile::get(void *p, size_t size) {
+	if (size > data.size() - offset) {
+		throw std::runtime_error("corrupt cache file");
+	}
+
+	memcpy(p, data.data() + offset, size);
+	offset += size;
+}
@@ -0,0 +1,38 @@
+#ifndef _PieDock_CacheFile_
+#define _PieDock_CacheFile_
+
+#include <stdint.h>
+
+#include <string>
+
+namespace PieDock {
+class CacheFile {
+public:
+	CacheFile() : offset(0) {}
+	virtual ~CacheFile() {}
+	inline const std::string &getData() const {
+		return data;
+	}
+	inline bool atEnd() const {
+		return offset >= data.size();
+	}
+	virtual bool read(const std::string &);
+	virtual bool write(const std::string &) const;
+	void putInt(int64_t);
+	void putDouble(double);
+	void putString(const std::string &);
+	int64_t getInt();
+	double getDouble();
+	std::string getString();
+	static uint64_t hash(const void *, size_t,
+		uint64_t = 0xcbf29ce484222325ULL);
+
+private:
+	std::string data;
+	std::string::size_type offset;
+
+	void get(void *, size_t);
+};
+}
+
+#endif
@@ -5,6 +5,9 @@
 
 using namespace PieDock;
 
+Cartouche::CornersCache Cartouche::cornersCache(
+	Cartouche::MaximumCorners);
+
 /**
  * Create plain solid rectangle
  *
@@ -15,21 +18,106 @@ using namespace PieDock;
  */
 Cartouche::Cartouche(int w, int h, int r, unsigned int c) :
 	ArgbSurface(w, h) {
-	bzero(getData(), getSize());
+	draw(*this, r, c);
+}
+
+/**
+ * Draw a cartouche that fills the whole surface; the corners are
+ * rendered once per radius and color and the straight parts in
+ * between are stretched to the required size
+ *
+ * @param s - surface
+ * @param r - radius of rounded corner in pixels
+ * @param c - color of rectangle (optional)
+ */
+void Cartouche::draw(ArgbSurface &s, int r, unsigned int c) {
+	const int width = s.getWidth();
+	const int height = s.getHeight();
+	const int corners = r << 1;
+	const int bytesPerLine = s.getBytesPerLine();
+	unsigned char *d = s.getData();
 
 	// check if there is enough space to draw rounded corners
-	{
-		int corners = r << 1;
-
-		if (!corners ||
-				w - corners < 1 ||
-				h - corners < 1) {
-			drawRectangle(0, 0, w, h, c);
-			return;
+	if (!corners ||
+			width - corners < 1 ||
+			height - corners < 1) {
+		for (int x = 0; x < width; ++x) {
+			memcpy(d + (x << 2), &c, sizeof(unsigned int));
+		}
+
+		for (int y = 1; y < height; ++y) {
+			memcpy(d + y * bytesPerLine, d, width << 2);
+		}
+
+		return;
+	}
+
+	const Cartouche &t = getCorners(r, c);
+	const int side = r << 2;
+	const int center = width - corners;
+	// row r of the template is both the last top row and the first
+	// bottom row of the cartouche
+	const int bottom = height - r - 1;
+
+	for (int y = 0; y < height; ++y) {
+		unsigned char *line = d + y * bytesPerLine;
+
+		if (y > r && y < bottom) {
+			// straight part in between is always solid
+			if (y == r + 1) {
+				for (int x = 0; x < width; ++x) {
+					memcpy(line + (x << 2), &c, sizeof(unsigned int));
+				}
+			} else {
+				memcpy(line, line - bytesPerLine, width << 2);
+			}
+
+			continue;
+		}
+
+		const unsigned char *src = t.getData() +
+			(y > r ? y - bottom + r : y) * t.getBytesPerLine();
+
+		memcpy(line, src, side);
+
+		for (unsigned char *p = line + side, *e = p + (center << 2);
+				p < e;
+				p += 4) {
+			memcpy(p, src + side, sizeof(unsigned int));
 		}
+
+		memcpy(line + side + (center << 2), src + side + 4, side);
+	}
+}
+
+/**
+ * Create template with corners of given radius; the template
+ * consists of four corners and a single pixel wide cross in between
+ *
+ * @param r - radius of rounded corner in pixels
+ * @param c - color of rectangle
+ */
+Cartouche::Cartouche(int r, unsigned int c) :
+	ArgbSurface((r << 1) + 1, (r << 1) + 1) {
+	bzero(getData(), getSize());
+	drawRoundedRectangle(0, 0, getWidth(), getHeight(), r, c);
+}
+
+/**
+ * Return corner template for given radius and color
+ *
+ * @param r - radius of rounded corner in pixels
+ * @param c - color of rectangle
+ */
+const Cartouche &Cartouche::getCorners(int r, unsigned int c) {
+	CornersKey key(r, c);
+	Cartouche *t;
+
+	if (!(t = cornersCache.get(key))) {
+		t = cornersCache.put(key, new Cartouche(r, c));
 	}
 
-	drawRoundedRectangle(0, 0, w, h, r, c);
+	return *t;
 }
 
 /**
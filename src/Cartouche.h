@@ -2,12 +2,26 @@
 #define _PieDock_Cartouche_
 
 #include "ArgbSurface.h"
+#include "LruCache.h"
+#include "Statistics.h"
+
+#include <utility>
 
 namespace PieDock {
 class Cartouche : public ArgbSurface {
 public:
 	Cartouche(int, int, int, unsigned int = 0xff000000);
 	virtual ~Cartouche() {}
+	static void draw(ArgbSurface &, int, unsigned int = 0xff000000);
+	static inline void prepare(int r, unsigned int c = 0xff000000) {
+		getCorners(r, c);
+	}
+	static inline void addCornersUsage(Statistics::Usage &u) {
+		u.entries += cornersCache.size();
+		u.bytes += cornersCache.getBytes();
+		u.hits += cornersCache.getHits();
+		u.misses += cornersCache.getMisses();
+	}
 
 protected:
 	struct Details {
@@ -23,6 +37,19 @@ protected:
 	virtual void drawRectangle(int, int, int, int, unsigned int);
 	virtual void drawRoundedRectangle(int, int, int, int, int, unsigned int);
 	virtual void drawCurveSlices(Details &, int, int, unsigned char);
+
+private:
+	enum {
+		MaximumCorners = 16
+	};
+
+	typedef std::pair<int, unsigned int> CornersKey;
+	typedef LruCache<CornersKey, Cartouche> CornersCache;
+
+	static CornersCache cornersCache;
+
+	Cartouche(int, unsigned int);
+	static const Cartouche &getCorners(int, unsigned int);
 };
 }
 
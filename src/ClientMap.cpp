@@ -0,0 +1,323 @@
+#include "ClientMap.h"
+#include "WindowManager.h"
+#include "Timings.h"
+
+#include <X11/Xutil.h>
+#include <X11/Xatom.h>
+
+#include <string.h>
+
+#include <algorithm>
+
+using namespace PieDock;
+
+/**
+ * Compare change serials
+ */
+struct ChangeIsOlder {
+	bool operator()(unsigned long s, const ClientMap::Change &c) const {
+		return s < c.serial;
+	}
+};
+
+/**
+ * Initialize client map; the list of clients is fetched lazily on the
+ * first call to update()
+ *
+ * @param d - display
+ */
+ClientMap::ClientMap(Display *d) :
+	display(d),
+	serial(0),
+	oldestSerial(0),
+	active(0),
+	listDirty(true),
+	activeDirty(true) {
+}
+
+/**
+ * Return client info for some window or 0 if the window isn't a client
+ *
+ * @param w - window
+ */
+const ClientMap::Client *ClientMap::getClient(Window w) const {
+	WindowToClient::const_iterator i;
+
+	if ((i = clients.find(w)) == clients.end()) {
+		return 0;
+	}
+
+	return &(*i).second;
+}
+
+/**
+ * Return first change that is newer than the given serial; if serial
+ * is older than getOldestSerial() some changes are missing and the
+ * caller needs to rebuild from getWindows() instead
+ *
+ * @param s - serial
+ */
+ClientMap::Changes::const_iterator ClientMap::getChangesSince(
+	unsigned long s) const {
+	return std::upper_bound(
+		changes.begin(),
+		changes.end(),
+		s,
+		ChangeIsOlder());
+}
+
+/**
+ * Bring client map up to date; this only talks to the X server for
+ * windows that have changed since the last call
+ */
+void ClientMap::update() {
+	Timings::Span span(Timings::ClientUpdate);
+	RequestCounter::Scope scope(display, RequestCounter::Update);
+	XErrorHandler defaultHandler = XSetErrorHandler(ignoreHandler);
+
+	if (activeDirty) {
+		active = WindowManager::getActive(display);
+		activeDirty = false;
+	}
+
+	if (listDirty) {
+		WindowManager::WindowList wl(display);
+		std::set<Window> listed;
+
+		for (WindowManager::WindowList::iterator i = wl.begin();
+				i != wl.end();
+				++i) {
+			listed.insert(*i);
+
+			if (clients.find(*i) != clients.end()) {
+				continue;
+			}
+
+			Client &c = clients[*i];
+
+			c.window = *i;
+
+			// get notified about title, class and geometry changes
+			XSelectInput(
+				display,
+				*i,
+				PropertyChangeMask |
+				StructureNotifyMask);
+
+			fetch(c);
+			log(*i);
+		}
+
+		for (Windows::iterator i = windows.begin();
+				i != windows.end();
+				++i) {
+			if (listed.find(*i) == listed.end()) {
+				clients.erase(*i);
+				dirty.erase(*i);
+				configured.erase(*i);
+				log(*i, true);
+			}
+		}
+
+		windows.assign(wl.begin(), wl.end());
+		listDirty = false;
+	}
+
+	for (DirtyWindows::iterator i = dirty.begin();
+			i != dirty.end();
+			++i) {
+		WindowToClient::iterator c;
+
+		if ((c = clients.find(*i)) == clients.end()) {
+			continue;
+		}
+
+		fetch((*c).second);
+		log(*i);
+	}
+
+	// geometry has already been taken from the events
+	for (DirtyWindows::iterator i = configured.begin();
+			i != configured.end();
+			++i) {
+		if (dirty.find(*i) == dirty.end() &&
+				clients.find(*i) != clients.end()) {
+			log(*i);
+		}
+	}
+
+	dirty.clear();
+	configured.clear();
+
+	XSetErrorHandler(defaultHandler);
+}
+
+/**
+ * Process X event; returns true if the event has been consumed
+ *
+ * @param event - X event
+ */
+bool ClientMap::processEvent(XEvent &event) {
+	Window w;
+
+	switch (event.type) {
+	case PropertyNotify:
+		if (event.xproperty.window == DefaultRootWindow(display)) {
+			Atom a = event.xproperty.atom;
+
+			if (a == WindowManager::getAtom(display, "_NET_CLIENT_LIST") ||
+					a == WindowManager::getAtom(display, "_WIN_CLIENT_LIST")) {
+				listDirty = true;
+				return true;
+			} else if (a == WindowManager::getAtom(
+					display,
+					"_NET_ACTIVE_WINDOW")) {
+				activeDirty = true;
+				return true;
+			}
+
+			return false;
+		}
+
+		w = event.xproperty.window;
+		break;
+	case ConfigureNotify:
+		w = event.xconfigure.window;
+		break;
+	case MapNotify:
+		w = event.xmap.window;
+		break;
+	case UnmapNotify:
+		w = event.xunmap.window;
+		break;
+	default:
+		return false;
+	}
+
+	WindowToClient::iterator c;
+
+	if ((c = clients.find(w)) == clients.end()) {
+		return false;
+	}
+
+	// a new geometry doesn't change name, class or title so there's
+	// no need to ask the server again
+	if (event.type == ConfigureNotify) {
+		XWindowAttributes &wa = (*c).second.attributes;
+
+		// synthetic events from the window manager carry root
+		// coordinates while attributes are relative to the parent
+		if (!event.xconfigure.send_event) {
+			wa.x = event.xconfigure.x;
+			wa.y = event.xconfigure.y;
+		}
+
+		wa.width = event.xconfigure.width;
+		wa.height = event.xconfigure.height;
+		wa.border_width = event.xconfigure.border_width;
+		wa.override_redirect = event.xconfigure.override_redirect;
+
+		configured.insert(w);
+
+		return true;
+	}
+
+	if (event.type == PropertyNotify) {
+		Atom a = event.xproperty.atom;
+
+		if (a != XA_WM_NAME &&
+				a != XA_WM_CLASS &&
+				a != WindowManager::getAtom(display, "_NET_WM_NAME") &&
+				a != WindowManager::getAtom(display, "_NET_WM_WINDOW_TYPE") &&
+				a != WindowManager::getAtom(display, "_NET_WM_DESKTOP") &&
+				a != WindowManager::getAtom(display, "_NET_WM_ICON")) {
+			return true;
+		}
+	}
+
+	// information is fetched on the next update() which
+	// coalesces bursts of events for the same window
+	dirty.insert(w);
+
+	return true;
+}
+
+/**
+ * Mark everything as outdated; information is fetched again on the
+ * next update()
+ */
+void ClientMap::invalidate() {
+	for (WindowToClient::iterator i = clients.begin();
+			i != clients.end();
+			++i) {
+		dirty.insert((*i).first);
+	}
+
+	listDirty = true;
+	activeDirty = true;
+}
+
+/**
+ * Fetch name, class, title and attributes of a client
+ *
+ * @param c - client
+ */
+void ClientMap::fetch(Client &c) {
+	XClassHint xch;
+
+	c.name.clear();
+	c.className.clear();
+	c.normal = false;
+
+	if (WindowManager::isNormalWindow(display, c.window)) {
+		RequestCounter::roundTrip();
+
+		if (XGetClassHint(display, c.window, &xch)) {
+			if (xch.res_name) {
+				c.name = xch.res_name;
+				XFree(xch.res_name);
+			}
+
+			if (xch.res_class) {
+				c.className = xch.res_class;
+				XFree(xch.res_class);
+			}
+
+			c.normal = true;
+		}
+	}
+
+	c.title = WindowManager::getTitle(display, c.window);
+
+	RequestCounter::roundTrip();
+
+	if (!XGetWindowAttributes(display, c.window, &c.attributes)) {
+		memset(&c.attributes, 0, sizeof(c.attributes));
+	}
+}
+
+/**
+ * Record a change
+ *
+ * @param w - window that has changed
+ * @param removed - true if the window is gone
+ */
+void ClientMap::log(Window w, bool removed) {
+	Change c = { ++serial, w, removed };
+
+	if (!removed) {
+		clients[w].serial = serial;
+	}
+
+	changes.push_back(c);
+
+	// drop the older half of the log; readers that haven't
+	// caught up in time need to rebuild everything
+	if (changes.size() > MaximumChanges) {
+		changes.erase(
+			changes.begin(),
+			changes.begin()+MaximumChanges/2);
+
+		oldestSerial = changes.front().serial-1;
+	}
+}
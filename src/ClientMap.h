@@ -0,0 +1,84 @@
+#ifndef _PieDock_ClientMap_
+#define _PieDock_ClientMap_
+
+#include <X11/Xlib.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+namespace PieDock {
+class ClientMap {
+public:
+	typedef struct {
+		Window window;
+		std::string name;
+		std::string className;
+		std::string title;
+		bool normal;
+		XWindowAttributes attributes;
+		unsigned long serial;
+	} Client;
+
+	typedef struct {
+		unsigned long serial;
+		Window window;
+		bool removed;
+	} Change;
+
+	typedef std::vector<Window> Windows;
+	typedef std::vector<Change> Changes;
+
+	ClientMap(Display *);
+	virtual ~ClientMap() {}
+	inline const Windows &getWindows() const {
+		return windows;
+	}
+	inline const Changes &getChanges() const {
+		return changes;
+	}
+	inline const unsigned long &getSerial() const {
+		return serial;
+	}
+	inline const unsigned long &getOldestSerial() const {
+		return oldestSerial;
+	}
+	inline const Window &getActive() const {
+		return active;
+	}
+	inline int getNumberOfClients() const {
+		return clients.size();
+	}
+	const Client *getClient(Window) const;
+	Changes::const_iterator getChangesSince(unsigned long) const;
+	virtual void update();
+	virtual bool processEvent(XEvent &);
+	virtual void invalidate();
+
+private:
+	enum {
+		MaximumChanges = 4096
+	};
+
+	typedef std::map<Window, Client> WindowToClient;
+	typedef std::set<Window> DirtyWindows;
+
+	Display *display;
+	WindowToClient clients;
+	Windows windows;
+	Changes changes;
+	DirtyWindows dirty;
+	DirtyWindows configured;
+	unsigned long serial;
+	unsigned long oldestSerial;
+	Window active;
+	bool listDirty;
+	bool activeDirty;
+
+	void fetch(Client &);
+	void log(Window, bool = false);
+};
+}
+
+#endif
@@ -0,0 +1,254 @@
+#include "Command.h"
+#include "ErrnoException.h"
+
+#include <spawn.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+
+#include <sstream>
+
+extern char **environ;
+
+using namespace PieDock;
+
+const std::string Command::WindowId = "$WID";
+
+/**
+ * Initialize command; the command line is split into arguments once
+ * so it can be executed without a shell if it doesn't use any shell
+ * features
+ *
+ * @param l - command line (optional)
+ */
+Command::Command(const std::string &l) :
+	line(l),
+	shell(false) {
+	parse();
+}
+
+/**
+ * Run command in a new session; returns process id of child
+ *
+ * @param w - window that replaces $WID (optional)
+ */
+pid_t Command::run(Window w) const {
+	Arguments a(arguments);
+
+	if (!substitutions.empty()) {
+		std::ostringstream oss;
+
+		oss << "0x" << std::hex << w;
+
+		// insert from the back so offsets stay valid
+		for (Substitutions::const_reverse_iterator i =
+					substitutions.rbegin();
+				i != substitutions.rend();
+				++i) {
+			a[(*i).argument].insert((*i).offset, oss.str());
+		}
+	}
+
+	std::vector<char *> argv;
+
+	if (shell) {
+		char *s = getenv("SHELL");
+
+		argv.push_back(s ? s : const_cast<char *>("/bin/sh"));
+		argv.push_back(const_cast<char *>("-c"));
+	}
+
+	for (Arguments::iterator i = a.begin(); i != a.end(); ++i) {
+		argv.push_back(const_cast<char *>((*i).c_str()));
+	}
+
+	argv.push_back(0);
+
+	posix_spawnattr_t attr;
+	sigset_t mask;
+	short flags = POSIX_SPAWN_SETSIGMASK;
+
+	// signals are blocked for the event loop
+	sigemptyset(&mask);
+
+#ifdef POSIX_SPAWN_SETSID
+	flags |= POSIX_SPAWN_SETSID;
+#else
+	flags |= POSIX_SPAWN_SETPGROUP;
+#endif
+
+	posix_spawnattr_init(&attr);
+	posix_spawnattr_setsigmask(&attr, &mask);
+	posix_spawnattr_setflags(&attr, flags);
+
+	// posix_spawn doesn't copy the address space of this process
+	// which may be big with all the cached icons
+	pid_t pid;
+	int error = posix_spawnp(&pid, argv[0], 0, &attr, &argv[0], environ);
+
+	posix_spawnattr_destroy(&attr);
+
+	if (error) {
+		errno = error;
+		throw ErrnoException();
+	}
+
+	return pid;
+}
+
+/**
+ * Split command line into arguments; falls back to the shell as soon
+ * as there's anything a shell would need to interpret
+ */
+void Command::parse() {
+	const std::string::size_type length = line.length();
+	std::string word;
+	bool inWord = false;
+	char quote = 0;
+
+	shell = false;
+	arguments.clear();
+	substitutions.clear();
+
+	for (std::string::size_type i = 0; i < length;) {
+		// $WID is substituted everywhere, even within quotes
+		if (isWindowId(i)) {
+			Substitution s = { arguments.size(), word.length() };
+
+			substitutions.push_back(s);
+			inWord = true;
+			i += WindowId.length();
+			continue;
+		}
+
+		char c = line[i++];
+
+		if (quote == '\'') {
+			if (c == '\'') {
+				quote = 0;
+			} else {
+				word += c;
+			}
+			continue;
+		} else if (quote == '"') {
+			if (c == '"') {
+				quote = 0;
+			} else if (c == '$' || c == '`') {
+				parseForShell();
+				return;
+			} else if (c == '\\' &&
+					i < length &&
+					strchr("$`\"\\", line[i])) {
+				word += line[i++];
+			} else {
+				word += c;
+			}
+			continue;
+		}
+
+		switch (c) {
+		case ' ':
+		case '\t':
+			if (inWord) {
+				arguments.push_back(word);
+				word.clear();
+				inWord = false;
+			}
+			continue;
+		case '\'':
+		case '"':
+			quote = c;
+			inWord = true;
+			continue;
+		case '\\':
+			if (i >= length || line[i] == '\n') {
+				parseForShell();
+				return;
+			}
+			word += line[i++];
+			inWord = true;
+			continue;
+		case '=':
+			// variable assignment
+			if (arguments.empty()) {
+				parseForShell();
+				return;
+			}
+			break;
+		case '#':
+		case '~':
+			// comment or home directory at the start of a word
+			if (!inWord) {
+				parseForShell();
+				return;
+			}
+			break;
+		default:
+			if (strchr("|&;<>()$`*?[]{}\n", c)) {
+				parseForShell();
+				return;
+			}
+			break;
+		}
+
+		word += c;
+		inWord = true;
+	}
+
+	if (quote) {
+		parseForShell();
+		return;
+	}
+
+	if (inWord) {
+		arguments.push_back(word);
+	}
+
+	if (arguments.empty()) {
+		parseForShell();
+	}
+}
+
+/**
+ * Pass command line to the shell as it is; only $WID is substituted
+ */
+void Command::parseForShell() {
+	std::string s;
+	std::string::size_type i = 0;
+
+	shell = true;
+	arguments.clear();
+	substitutions.clear();
+
+	for (std::string::size_type p = 0;
+			(p = line.find(WindowId, p)) != std::string::npos;
+			p += WindowId.length()) {
+		if (!isWindowId(p)) {
+			continue;
+		}
+
+		s.append(line, i, p - i);
+		i = p + WindowId.length();
+
+		Substitution sub = { 0, s.length() };
+		substitutions.push_back(sub);
+	}
+
+	s.append(line, i, std::string::npos);
+	arguments.push_back(s);
+}
+
+/**
+ * Returns true if $WID starts at the given offset
+ *
+ * @param i - offset in command line
+ */
+bool Command::isWindowId(std::string::size_type i) const {
+	std::string::size_type e = i + WindowId.length();
+
+	return !line.compare(i, WindowId.length(), WindowId) &&
+		(e >= line.length() ||
+			!(isalnum(line[e]) || line[e] == '_'));
+}
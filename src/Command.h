@@ -0,0 +1,51 @@
+#ifndef _PieDock_Command_
+#define _PieDock_Command_
+
+#include <X11/Xlib.h>
+
+#include <sys/types.h>
+
+#include <string>
+#include <vector>
+
+namespace PieDock {
+class Command {
+public:
+	Command(const std::string & = "");
+	virtual ~Command() {}
+	inline const std::string &getLine() const {
+		return line;
+	}
+	inline const bool &needsShell() const {
+		return shell;
+	}
+	inline bool usesWindow() const {
+		return !substitutions.empty();
+	}
+	virtual pid_t run(Window = 0) const;
+
+protected:
+	virtual void parse();
+	virtual void parseForShell();
+
+private:
+	typedef std::vector<std::string> Arguments;
+
+	typedef struct {
+		Arguments::size_type argument;
+		std::string::size_type offset;
+	} Substitution;
+
+	typedef std::vector<Substitution> Substitutions;
+
+	static const std::string WindowId;
+	std::string line;
+	bool shell;
+	Arguments arguments;
+	Substitutions substitutions;
+
+	bool isWindowId(std::string::size_type) const;
+};
+}
+
+#endif
@@ -0,0 +1,197 @@
+#include "ControlClient.h"
+#include "ErrnoException.h"
+
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <vector>
+#include <stdexcept>
+
+using namespace PieDock;
+
+const char ControlClient::StopMarker = '\n';
+const char *ControlClient::Show = "show";
+
+/**
+ * Initialize control client; this must not depend on X or any toolkit
+ * since it runs before any of them is initialized
+ *
+ * @param configurationFile - configuration file of the instance to talk to
+ */
+ControlClient::ControlClient(const std::string &configurationFile) :
+	socketFile(getSocketFile(configurationFile)) {
+}
+
+/**
+ * Return path of the control socket for some configuration file; throws
+ * if the path doesn't fit into a socket address
+ *
+ * @param configurationFile - configuration file
+ */
+std::string ControlClient::getSocketFile(
+	const std::string &configurationFile) {
+	std::string f = configurationFile + "-socket";
+
+	if (f.size() >= sizeof(((struct sockaddr_un *) 0)->sun_path)) {
+		throw std::invalid_argument("path of control socket too long");
+	}
+
+	return f;
+}
+
+/**
+ * Ask a running instance to show a menu; returns false if there
+ * is no running instance
+ *
+ * @param menu - name of menu to open (optional)
+ */
+bool ControlClient::show(const char *menu) const {
+	std::string cmd = Show;
+
+	if (menu) {
+		cmd += std::string(" ") + menu;
+	}
+
+	return send(cmd + StopMarker);
+}
+
+/**
+ * Send message to a running instance; returns false if there
+ * is no running instance
+ *
+ * @param message - message
+ */
+bool ControlClient::send(const std::string &message) const {
+	int s;
+
+	if ((s = open(false)) < 0) {
+		return false;
+	}
+
+	if (::send(s, message.c_str(), message.size(), 0) < 0) {
+		int e = errno;
+
+		close(s);
+		errno = e;
+		throw ErrnoException();
+	}
+
+	close(s);
+
+	return true;
+}
+
+/**
+ * Send one or more commands, one per line, to a running instance and
+ * wait for its reply; returns false if there is no running instance
+ *
+ * @param message - commands
+ * @param reply - reply of running instance
+ * @param timeout - how long to wait for the reply in milliseconds
+ *                  (optional)
+ */
+bool ControlClient::request(
+	const std::string &message,
+	std::string &reply,
+	int timeout) const {
+	int s;
+
+	if ((s = open(true)) < 0) {
+		return false;
+	}
+
+	struct pollfd pfd;
+	std::vector<char> buffer(MaximumReply);
+	ssize_t n = 0;
+
+	pfd.fd = s;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	if (::send(s, message.c_str(), message.size(), 0) < 0 ||
+			poll(&pfd, 1, timeout) < 0 ||
+			(pfd.revents & POLLIN &&
+				(n = recv(s, &buffer[0], buffer.size(), 0)) < 0)) {
+		int e = errno;
+
+		close(s);
+		errno = e;
+		throw ErrnoException();
+	}
+
+	close(s);
+
+	if (!(pfd.revents & POLLIN)) {
+		throw std::runtime_error("no reply from running instance");
+	}
+
+	reply.assign(&buffer[0], n);
+
+	return true;
+}
+
+/**
+ * Open and connect a socket to the running instance; returns -1 if
+ * there is no running instance
+ *
+ * @param replies - true to bind the socket to an address so the
+ *                  running instance can reply
+ */
+int ControlClient::open(bool replies) const {
+	struct stat buf;
+
+	if (stat(socketFile.c_str(), &buf) < 0) {
+		return -1;
+	}
+
+	struct sockaddr_un address;
+	int s;
+
+	if ((s = socket(PF_UNIX, SOCK_DGRAM, 0)) < 0) {
+		throw ErrnoException();
+	}
+
+	memset(&address, 0, sizeof(struct sockaddr_un));
+
+	address.sun_family = AF_LOCAL;
+
+	// binding with just the address family makes the kernel pick
+	// an unique abstract address
+	if (replies && bind(s,
+			(struct sockaddr *) &address,
+			sizeof(sa_family_t)) < 0) {
+		int e = errno;
+
+		close(s);
+		errno = e;
+		throw ErrnoException();
+	}
+
+	strncpy(
+		reinterpret_cast<char *>(address.sun_path),
+		socketFile.c_str(),
+		sizeof(address.sun_path) - 1);
+
+	if (connect(s,
+			(struct sockaddr *) &address,
+			sizeof(struct sockaddr_un)) < 0) {
+		int e = errno;
+
+		close(s);
+
+		// if there's no listener assume the file has been left
+		// over from a previous instance and try to remove it
+		// to start anew
+		if (e != ECONNREFUSED || unlink(socketFile.c_str())) {
+			errno = e;
+			throw ErrnoException();
+		}
+
+		return -1;
+	}
+
+	return s;
+}
@@ -0,0 +1,35 @@
+#ifndef _PieDock_ControlClient_
+#define _PieDock_ControlClient_
+
+#include <string>
+
+namespace PieDock {
+class ControlClient {
+public:
+	enum {
+		ProtocolVersion = 1,
+		MaximumMessage = 4096,
+		MaximumReply = 65536
+	};
+
+	static const char StopMarker;
+	static const char *Show;
+
+	ControlClient(const std::string &);
+	virtual ~ControlClient() {}
+	inline const std::string &getSocketFile() const {
+		return socketFile;
+	}
+	static std::string getSocketFile(const std::string &);
+	bool show(const char * = 0) const;
+	bool send(const std::string &) const;
+	bool request(const std::string &, std::string &, int = 1000) const;
+
+private:
+	int open(bool) const;
+
+	std::string socketFile;
+};
+}
+
+#endif
@@ -0,0 +1,323 @@
+#include "EventLoop.h"
+#include "ErrnoException.h"
+#include "Timings.h"
+
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+#ifdef HAVE_SYS_SIGNALFD_H
+#include <sys/signalfd.h>
+#endif
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace PieDock;
+
+#ifndef HAVE_SYS_SIGNALFD_H
+int EventLoop::signalPipe[2] = { -1, -1 };
+#endif
+
+/**
+ * Initialize event loop; uses epoll and signalfd if available and
+ * falls back to poll and a self-pipe otherwise
+ */
+EventLoop::EventLoop() :
+	fd(-1),
+	signalFd(-1) {
+#ifdef HAVE_SYS_EPOLL_H
+	if ((fd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+		throw ErrnoException();
+	}
+#endif
+}
+
+/**
+ * Clean up
+ */
+EventLoop::~EventLoop() {
+	if (signalFd > -1) {
+		close(signalFd);
+	}
+
+#ifndef HAVE_SYS_SIGNALFD_H
+	if (signalPipe[1] > -1) {
+		close(signalPipe[1]);
+		signalPipe[0] = signalPipe[1] = -1;
+	}
+#endif
+
+	if (fd > -1) {
+		close(fd);
+	}
+}
+
+/**
+ * Watch descriptor for readability
+ *
+ * @param d - file descriptor
+ * @param h - handler to call when the descriptor becomes readable
+ */
+void EventLoop::add(int d, Handler *h) {
+	if (handlers.find(d) != handlers.end()) {
+		handlers[d] = h;
+		return;
+	}
+
+#ifdef HAVE_SYS_EPOLL_H
+	struct epoll_event ev;
+
+	ev.events = EPOLLIN;
+	ev.data.fd = d;
+
+	if (epoll_ctl(fd, EPOLL_CTL_ADD, d, &ev) < 0) {
+		throw ErrnoException();
+	}
+#endif
+
+	handlers[d] = h;
+}
+
+/**
+ * Stop watching descriptor
+ *
+ * @param d - file descriptor
+ */
+void EventLoop::remove(int d) {
+	if (handlers.erase(d) < 1) {
+		return;
+	}
+
+#ifdef HAVE_SYS_EPOLL_H
+	epoll_ctl(fd, EPOLL_CTL_DEL, d, 0);
+#endif
+}
+
+/**
+ * Deliver signal to handler within the event loop instead of
+ * interrupting whatever is running
+ *
+ * @param signo - signal number
+ * @param h - handler
+ */
+void EventLoop::addSignal(int signo, SignalHandler *h) {
+	signalHandlers[signo] = h;
+
+#ifdef HAVE_SYS_SIGNALFD_H
+	sigset_t mask;
+
+	sigemptyset(&mask);
+
+	for (SignalToHandler::iterator i = signalHandlers.begin();
+			i != signalHandlers.end();
+			++i) {
+		sigaddset(&mask, (*i).first);
+	}
+
+	if (sigprocmask(SIG_BLOCK, &mask, 0) < 0 ||
+			(signalFd = signalfd(
+				signalFd,
+				&mask,
+				SFD_NONBLOCK | SFD_CLOEXEC)) < 0) {
+		throw ErrnoException();
+	}
+#else
+	if (signalFd < 0) {
+		if (pipe(signalPipe) < 0) {
+			throw ErrnoException();
+		}
+
+		for (int n = 2; n--;) {
+			fcntl(signalPipe[n], F_SETFL,
+				fcntl(signalPipe[n], F_GETFL) | O_NONBLOCK);
+			fcntl(signalPipe[n], F_SETFD, FD_CLOEXEC);
+		}
+
+		signalFd = signalPipe[0];
+	}
+
+	struct sigaction sa;
+
+	sa.sa_handler = forwardSignal;
+	sa.sa_flags = SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+
+	if (sigaction(signo, &sa, 0) < 0) {
+		throw ErrnoException();
+	}
+#endif
+
+#ifdef HAVE_SYS_EPOLL_H
+	struct epoll_event ev;
+
+	ev.events = EPOLLIN;
+	ev.data.fd = signalFd;
+
+	// it's fine if signalfd() has returned a descriptor
+	// that is already being watched
+	if (epoll_ctl(fd, EPOLL_CTL_ADD, signalFd, &ev) < 0 &&
+			errno != EEXIST) {
+		throw ErrnoException();
+	}
+#endif
+}
+
+/**
+ * Wait for descriptors to become readable and call their handlers;
+ * returns the number of descriptors that have been handled, 0 on
+ * timeout or if interrupted
+ *
+ * @param timeout - timeout in milliseconds, -1 to wait forever (optional)
+ */
+int EventLoop::wait(int timeout) {
+#ifdef HAVE_SYS_EPOLL_H
+	enum {
+		MaximumEvents = 16
+	};
+
+	struct epoll_event events[MaximumEvents];
+	int n;
+
+	{
+		Timings::Span span(Timings::Wait, timeout);
+
+		n = epoll_wait(fd, events, MaximumEvents, timeout);
+	}
+
+	if (n < 0) {
+		if (errno == EINTR) {
+			return 0;
+		}
+
+		throw ErrnoException();
+	}
+
+	for (int i = 0; i < n; ++i) {
+		dispatch(events[i].data.fd);
+	}
+
+	return n;
+#else
+	std::vector<struct pollfd> pfds;
+
+	for (DescriptorToHandler::iterator i = handlers.begin();
+			i != handlers.end();
+			++i) {
+		struct pollfd p = { (*i).first, POLLIN, 0 };
+
+		pfds.push_back(p);
+	}
+
+	if (signalFd > -1) {
+		struct pollfd p = { signalFd, POLLIN, 0 };
+
+		pfds.push_back(p);
+	}
+
+	int n;
+
+	{
+		Timings::Span span(Timings::Wait, timeout);
+
+		n = poll(&pfds[0], pfds.size(), timeout);
+	}
+
+	if (n < 0) {
+		if (errno == EINTR) {
+			return 0;
+		}
+
+		throw ErrnoException();
+	}
+
+	// handlers may add or remove descriptors
+	ready.clear();
+
+	for (std::vector<struct pollfd>::iterator i = pfds.begin();
+			i != pfds.end();
+			++i) {
+		if ((*i).revents) {
+			ready.push_back((*i).fd);
+		}
+	}
+
+	for (std::vector<int>::iterator i = ready.begin();
+			i != ready.end();
+			++i) {
+		dispatch(*i);
+	}
+
+	return n;
+#endif
+}
+
+/**
+ * Call handler of descriptor
+ *
+ * @param d - file descriptor
+ */
+void EventLoop::dispatch(int d) {
+	if (d == signalFd) {
+		readSignals();
+		return;
+	}
+
+	DescriptorToHandler::iterator i;
+
+	if ((i = handlers.find(d)) != handlers.end()) {
+		(*i).second->handleDescriptor(d);
+	}
+}
+
+/**
+ * Read pending signals and call their handlers
+ */
+void EventLoop::readSignals() {
+	for (;;) {
+		int signo;
+
+#ifdef HAVE_SYS_SIGNALFD_H
+		struct signalfd_siginfo si;
+
+		if (read(signalFd, &si, sizeof(si)) != sizeof(si)) {
+			break;
+		}
+
+		signo = si.ssi_signo;
+#else
+		unsigned char c;
+
+		if (read(signalFd, &c, 1) != 1) {
+			break;
+		}
+
+		signo = c;
+#endif
+
+		SignalToHandler::iterator i;
+
+		if ((i = signalHandlers.find(signo)) != signalHandlers.end()) {
+			(*i).second->handleSignal(signo);
+		}
+	}
+}
+
+#ifndef HAVE_SYS_SIGNALFD_H
+/**
+ * Forward signal to the event loop
+ *
+ * @param signo - signal number
+ */
+void EventLoop::forwardSignal(int signo) {
+	int e = errno;
+	unsigned char c = static_cast<unsigned char>(signo);
+
+	if (write(signalPipe[1], &c, 1) < 0) {
+		// nothing to do about it in a signal handler
+	}
+
+	errno = e;
+}
+#endif
@@ -0,0 +1,51 @@
+#ifndef _PieDock_EventLoop_
+#define _PieDock_EventLoop_
+
+#include <map>
+#include <vector>
+
+namespace PieDock {
+class EventLoop {
+public:
+	class Handler {
+	public:
+		virtual ~Handler() {}
+		virtual void handleDescriptor(int) = 0;
+	};
+
+	class SignalHandler {
+	public:
+		virtual ~SignalHandler() {}
+		virtual void handleSignal(int) = 0;
+	};
+
+	EventLoop();
+	virtual ~EventLoop();
+	virtual void add(int, Handler *);
+	virtual void remove(int);
+	virtual void addSignal(int, SignalHandler *);
+	virtual int wait(int = -1);
+
+private:
+	typedef std::map<int, Handler *> DescriptorToHandler;
+	typedef std::map<int, SignalHandler *> SignalToHandler;
+
+	int fd;
+	int signalFd;
+	DescriptorToHandler handlers;
+	SignalToHandler signalHandlers;
+#ifndef HAVE_SYS_EPOLL_H
+	std::vector<int> ready;
+#endif
+#ifndef HAVE_SYS_SIGNALFD_H
+	static int signalPipe[2];
+
+	static void forwardSignal(int);
+#endif
+
+	void dispatch(int);
+	void readSignals();
+};
+}
+
+#endif
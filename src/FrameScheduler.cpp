@@ -0,0 +1,158 @@
+#include "FrameScheduler.h"
+#include "ErrnoException.h"
+
+#ifdef HAVE_SYS_TIMERFD_H
+#include <sys/timerfd.h>
+#endif
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+
+using namespace PieDock;
+
+/**
+ * Initialize frame scheduler; uses a timerfd if available, otherwise
+ * the caller needs to wait for getTimeout()
+ *
+ * @param fps - frames per second (optional)
+ */
+FrameScheduler::FrameScheduler(int fps) :
+	fd(-1),
+	running(false),
+	next(0),
+	dropped(0) {
+#ifdef HAVE_SYS_TIMERFD_H
+	if ((fd = timerfd_create(
+			CLOCK_MONOTONIC,
+			TFD_NONBLOCK | TFD_CLOEXEC)) < 0) {
+		throw ErrnoException();
+	}
+#endif
+
+	setRate(fps);
+}
+
+/**
+ * Clean up
+ */
+FrameScheduler::~FrameScheduler() {
+	if (fd > -1) {
+		close(fd);
+	}
+}
+
+/**
+ * Return monotonic time in seconds
+ */
+double FrameScheduler::now() {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return static_cast<double>(ts.tv_sec) +
+		static_cast<double>(ts.tv_nsec) / 1000000000.0;
+}
+
+/**
+ * Set frame rate
+ *
+ * @param fps - frames per second
+ */
+void FrameScheduler::setRate(int fps) {
+	if (fps < 1) {
+		fps = 1;
+	}
+
+	interval = 1.0 / static_cast<double>(fps);
+
+	if (running) {
+		stop();
+		start();
+	}
+}
+
+/**
+ * Start emitting frames
+ */
+void FrameScheduler::start() {
+	if (running) {
+		return;
+	}
+
+	running = true;
+	next = now() + interval;
+
+#ifdef HAVE_SYS_TIMERFD_H
+	struct itimerspec its;
+
+	its.it_interval.tv_sec = static_cast<time_t>(interval);
+	its.it_interval.tv_nsec = static_cast<long>(
+		(interval - its.it_interval.tv_sec) * 1000000000.0);
+	its.it_value = its.it_interval;
+
+	timerfd_settime(fd, 0, &its, 0);
+#endif
+}
+
+/**
+ * Stop emitting frames
+ */
+void FrameScheduler::stop() {
+	if (!running) {
+		return;
+	}
+
+	running = false;
+
+#ifdef HAVE_SYS_TIMERFD_H
+	struct itimerspec its = { { 0, 0 }, { 0, 0 } };
+
+	timerfd_settime(fd, 0, &its, 0);
+#endif
+}
+
+/**
+ * Returns true if the next frame is due; only required if there's no
+ * descriptor to wait for
+ */
+bool FrameScheduler::isDue() const {
+	return running && now() >= next;
+}
+
+/**
+ * Return milliseconds until the next frame is due; only required if
+ * there's no descriptor to wait for
+ */
+int FrameScheduler::getTimeout() const {
+	double d = next - now();
+
+	if (d < 0) {
+		return 0;
+	}
+
+	return static_cast<int>(ceil(d * 1000.0));
+}
+
+/**
+ * Acknowledge that a frame is due; frames that have been missed
+ * because rendering fell behind are dropped instead of being caught up
+ */
+void FrameScheduler::tick() {
+#ifdef HAVE_SYS_TIMERFD_H
+	uint64_t expirations;
+
+	if (read(fd, &expirations, sizeof(expirations)) ==
+			sizeof(expirations) &&
+			expirations > 1) {
+		dropped += expirations - 1;
+	}
+#else
+	double t = now();
+
+	if ((next += interval) < t) {
+		dropped += static_cast<unsigned long>((t - next) / interval) + 1;
+		next = t + interval;
+	}
+#endif
+}
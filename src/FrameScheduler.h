@@ -0,0 +1,35 @@
+#ifndef _PieDock_FrameScheduler_
+#define _PieDock_FrameScheduler_
+
+namespace PieDock {
+class FrameScheduler {
+public:
+	FrameScheduler(int = 100);
+	virtual ~FrameScheduler();
+	inline const bool &isRunning() const {
+		return running;
+	}
+	inline const int &getDescriptor() const {
+		return fd;
+	}
+	inline const unsigned long &getDroppedFrames() const {
+		return dropped;
+	}
+	static double now();
+	virtual void setRate(int);
+	virtual void start();
+	virtual void stop();
+	virtual bool isDue() const;
+	virtual int getTimeout() const;
+	virtual void tick();
+
+private:
+	int fd;
+	bool running;
+	double interval;
+	double next;
+	unsigned long dropped;
+};
+}
+
+#endif
@@ -1,4 +1,6 @@
 #include "Hotspot.h"
+#include "Timings.h"
+#include "RequestCounter.h"
 
 using namespace PieDock;
 
@@ -9,6 +11,9 @@ using namespace PieDock;
  * @param w - relative to which window, if not given the root window (optional)
  */
 Hotspot::Hotspot(Display *d, Window w) {
+	Timings::Span span(Timings::RoundTrip);
+
+	RequestCounter::roundTrip();
 	XQueryPointer(
 		d,
 		(w ? w : DefaultRootWindow(d)),
@@ -1,6 +1,7 @@
 #include "IconMap.h"
 #include "WildcardCompare.h"
 #include "Png.h"
+#include "Timings.h"
 
 #include <string.h> // memset()
 
@@ -630,6 +631,84 @@ void IconMap::reset() {
 	freeIcons();
 }
 
+/**
+ * Returns true if some other icon map resolves names to the same files
+ *
+ * @param other - other icon map
+ */
+bool IconMap::isEquivalent(const IconMap &other) const {
+	return paths == other.paths &&
+		nameToFile == other.nameToFile &&
+		classToFile == other.classToFile &&
+		titleToFile == other.titleToFile &&
+		fileForMissing == other.fileForMissing &&
+		fileForFiller == other.fileForFiller;
+}
+
+/**
+ * Take over all icons of some other, equivalent icon map
+ *
+ * @param other - other icon map, loses its icons
+ */
+void IconMap::adopt(IconMap &other) {
+	freeIcons();
+
+	cache.swap(other.cache);
+	std::swap(missingSurface, other.missingSurface);
+	std::swap(fillerSurface, other.fillerSurface);
+	std::swap(hits, other.hits);
+	std::swap(misses, other.misses);
+}
+
+/**
+ * Return number of resized icon surfaces in cache
+ */
+int IconMap::getNumberOfSizes() const {
+	int n = 0;
+
+	for (FileToIcon::const_iterator i = cache.begin();
+			i != cache.end();
+			++i) {
+		n += (*i).second->getNumberOfSizes();
+	}
+
+	return n;
+}
+
+/**
+ * Add number, size and look ups of icons and their resized surfaces
+ * to usage
+ *
+ * @param icons - usage of icons
+ * @param sizes - usage of resized surfaces
+ */
+void IconMap::addUsage(
+	Statistics::Usage &icons,
+	Statistics::Usage &sizes) const {
+	for (FileToIcon::const_iterator i = cache.begin();
+			i != cache.end();
+			++i) {
+		icons.bytes += (*i).second->getSurface().getSize();
+		(*i).second->addUsage(sizes);
+	}
+
+	icons.entries += cache.size();
+	icons.hits += hits;
+	icons.misses += misses;
+}
+
+/**
+ * Drop all resized icon surfaces; icons themselves need to stay since
+ * menu items refer to them
+ */
+void IconMap::flushSizes() {
+	for (FileToIcon::iterator i = cache.begin();
+			i != cache.end();
+			++i) {
+		(*i).second->clear();
+	}
+}
+
 /**
  * Add name alias
  *
@@ -668,6 +747,7 @@ void IconMap::addTitleAlias(std::string a, std::string n) {
  * @param n - resource name
  */
 Icon *IconMap::getIcon(std::string t, std::string c, std::string n) {
+	Timings::Span span(Timings::IconLookup);
 	Icon *icon;
 
 	if (!(icon = getIconByTitle(t)) &&
@@ -699,10 +779,13 @@ Icon *IconMap::getIconByName(std::string n) {
 		FileToIcon::iterator i;
 
 		if ((i = cache.find(n)) != cache.end()) {
+			++hits;
 			return (*i).second;
 		}
 	}
 
+	++misses;
+
 	// load PNG file from disk
 	{
 		std::string file = n+".png";
@@ -11,10 +11,13 @@ namespace PieDock {
 class IconMap {
 public:
 	typedef std::vector<std::string> Paths;
+	typedef std::map<std::string, std::string> AliasToFile;
 
 	IconMap() :
 		missingSurface(0),
-		fillerSurface(0) {}
+		fillerSurface(0),
+		hits(0),
+		misses(0) {}
 	virtual ~IconMap();
 	virtual inline void addPath(const std::string p) {
 		paths.push_back(p);
@@ -34,7 +37,24 @@ public:
 	virtual inline const std::string &getFileForFiller() const {
 		return fileForFiller;
 	}
+	inline int getNumberOfIcons() const {
+		return cache.size();
+	}
+	inline const AliasToFile &getNameAliases() const {
+		return nameToFile;
+	}
+	inline const AliasToFile &getClassAliases() const {
+		return classToFile;
+	}
+	inline const AliasToFile &getTitleAliases() const {
+		return titleToFile;
+	}
 	virtual void reset();
+	virtual bool isEquivalent(const IconMap &) const;
+	virtual void adopt(IconMap &);
+	virtual int getNumberOfSizes() const;
+	virtual void flushSizes();
+	virtual void addUsage(Statistics::Usage &, Statistics::Usage &) const;
 	virtual void addNameAlias(std::string, std::string);
 	virtual void addClassAlias(std::string, std::string);
 	virtual void addTitleAlias(std::string, std::string);
@@ -49,7 +69,6 @@ public:
 	virtual void saveIcon(const ArgbSurface *, const std::string) const;
 
 protected:
-	typedef std::map<std::string, std::string> AliasToFile;
 	typedef std::map<std::string, Icon *> FileToIcon;
 
 	virtual void freeIcons();
@@ -65,6 +84,8 @@ private:
 	ArgbSurface *fillerSurface;
 	std::string fileForMissing;
 	std::string fileForFiller;
+	unsigned long hits;
+	unsigned long misses;
 };
 }
 
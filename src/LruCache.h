@@ -0,0 +1,130 @@
+#ifndef _PieDock_LruCache_
+#define _PieDock_LruCache_
+
+#include <list>
+#include <map>
+
+namespace PieDock {
+/**
+ * Map of owned objects that drops the least recently used object
+ * when it grows beyond a maximum number of entries
+ */
+template <class K, class V> class LruCache {
+public:
+	LruCache(unsigned int m) :
+		maximum(m),
+		hits(0),
+		misses(0) {}
+	virtual ~LruCache() {
+		clear();
+	}
+	inline unsigned int size() const {
+		return keyToEntry.size();
+	}
+	inline const unsigned long &getHits() const {
+		return hits;
+	}
+	inline const unsigned long &getMisses() const {
+		return misses;
+	}
+
+	/**
+	 * Return cached object or 0 if there is none; the object becomes
+	 * the most recently used one
+	 *
+	 * @param key - key of object
+	 */
+	V *get(const K &key) {
+		typename KeyToEntry::iterator i;
+
+		if ((i = keyToEntry.find(key)) == keyToEntry.end()) {
+			++misses;
+			return 0;
+		}
+
+		++hits;
+		order.splice(order.begin(), order, (*i).second.position);
+
+		return (*i).second.value;
+	}
+
+	/**
+	 * Add object to cache; the cache takes ownership
+	 *
+	 * @param key - key of object
+	 * @param value - object
+	 */
+	V *put(const K &key, V *value) {
+		typename KeyToEntry::iterator i;
+
+		if ((i = keyToEntry.find(key)) != keyToEntry.end()) {
+			delete (*i).second.value;
+			(*i).second.value = value;
+			order.splice(order.begin(), order, (*i).second.position);
+
+			return value;
+		}
+
+		order.push_front(key);
+
+		Entry e = { value, order.begin() };
+		keyToEntry.insert(std::make_pair(key, e));
+
+		while (keyToEntry.size() > maximum) {
+			i = keyToEntry.find(order.back());
+			delete (*i).second.value;
+			keyToEntry.erase(i);
+			order.pop_back();
+		}
+
+		return value;
+	}
+
+	/**
+	 * Return sum of getSize() of all objects
+	 */
+	unsigned long getBytes() const {
+		unsigned long bytes = 0;
+
+		for (typename KeyToEntry::const_iterator i = keyToEntry.begin();
+				i != keyToEntry.end();
+				++i) {
+			bytes += (*i).second.value->getSize();
+		}
+
+		return bytes;
+	}
+
+	/**
+	 * Drop all objects
+	 */
+	void clear() {
+		for (typename KeyToEntry::iterator i = keyToEntry.begin();
+				i != keyToEntry.end();
+				++i) {
+			delete (*i).second.value;
+		}
+
+		keyToEntry.clear();
+		order.clear();
+	}
+
+private:
+	typedef std::list<K> Order;
+
+	typedef struct {
+		V *value;
+		typename Order::iterator position;
+	} Entry;
+
+	typedef std::map<K, Entry> KeyToEntry;
+
+	unsigned int maximum;
+	Order order;
+	KeyToEntry keyToEntry;
+	unsigned long hits;
+	unsigned long misses;
+};
+}
+
+#endif
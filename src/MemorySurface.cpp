@@ -0,0 +1,75 @@
+#include "MemorySurface.h"
+
+#include <string.h>
+#include <stdint.h>
+
+#include <stdexcept>
+
+using namespace PieDock;
+
+/**
+ * Create a canvas in plain memory that uses the same pixel layouts
+ * as the XImage of a window
+ *
+ * @param w - width of surface in pixels
+ * @param h - height of surface in pixels
+ * @param d - color depth, bits per pixel (optional)
+ */
+MemorySurface::MemorySurface(int w, int h, int d) : Surface() {
+	if (d != HighColor && d != RGB && d != ARGB) {
+		throw std::invalid_argument("color depth not supported");
+	}
+
+	calculateSize(w, h, d);
+	allocateData();
+	clear();
+}
+
+/**
+ * Set all pixels to black
+ */
+void MemorySurface::clear() {
+	memset(getData(), 0, getSize());
+}
+
+/**
+ * Convert canvas into an opaque ARGB surface; the alpha channel of a
+ * 32 bit canvas is only maintained for compositing and is dropped
+ */
+ArgbSurface *MemorySurface::getArgbSurface() const {
+	ArgbSurface *argb = new ArgbSurface(getWidth(), getHeight());
+	uint32_t *dest = reinterpret_cast<uint32_t *>(argb->getData());
+
+	for (int y = 0; y < getHeight(); ++y) {
+		const unsigned char *src = getData() + y * getBytesPerLine();
+
+		for (int x = getWidth(); x--; src += getBytesPerPixel()) {
+			uint32_t pixel;
+
+			switch (getBytesPerPixel()) {
+			default:
+			case 4:
+				pixel = *reinterpret_cast<const uint32_t *>(src);
+				break;
+			case 3:
+				pixel = src[2] << 16 | src[1] << 8 | src[0];
+				break;
+			case 2:
+				{
+					uint16_t p = *reinterpret_cast<const uint16_t *>(src);
+
+					// same layout as Blender::blendInto16Bit()
+					pixel =
+						((p >> 8) & 0xf8) << 16 |
+						((p >> 3) & 0xfc) << 8 |
+						((p << 3) & 0xf8);
+				}
+				break;
+			}
+
+			*(dest++) = 0xff000000 | pixel;
+		}
+	}
+
+	return argb;
+}
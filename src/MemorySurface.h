@@ -0,0 +1,17 @@
+#ifndef _PieDock_MemorySurface_
+#define _PieDock_MemorySurface_
+
+#include "Surface.h"
+#include "ArgbSurface.h"
+
+namespace PieDock {
+class MemorySurface : public Surface {
+public:
+	MemorySurface(int, int, int = ARGB);
+	virtual ~MemorySurface() {}
+	virtual void clear();
+	virtual ArgbSurface *getArgbSurface() const;
+};
+}
+
+#endif
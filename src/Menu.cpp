@@ -1,14 +1,14 @@
 #include "Menu.h"
+#include "WindowPool.h"
 #include "WindowManager.h"
 #include "WorkspaceLayout.h"
 #include "MenuItemWithWorkspaces.h"
+#include "Timings.h"
+#include "RequestCounter.h"
 
-#include <X11/Xutil.h>
-#include <unistd.h>
-#include <stdlib.h>
-
-#include <sstream>
+#include <iostream>
 #include <stdexcept>
+#include <algorithm>
 
 using namespace PieDock;
 
@@ -32,6 +32,9 @@ Menu::Menu(Application *a) :
  *                    to the same application (optional)
  */
 bool Menu::update(std::string menuName, Window forWindow) {
+	Timings::Span span(Timings::MenuUpdate);
+	RequestCounter::Scope scope(app->getDisplay(), RequestCounter::Update);
+
 	if (!forWindow &&
 			!(menuItems = app->getSettings()->getMenu(menuName))) {
 		return false;
@@ -43,217 +46,264 @@ bool Menu::update(std::string menuName, Window forWindow) {
 
 	name = menuName;
 
-	// multiple windows per icon
-	typedef std::map<Icon *, MenuItem *> IconToItem;
-	IconToItem iconToItem;
+	// move menu item to the top when one icon per window is used
+	if (menuItems->oneIconPerWindow() && selected) {
+		MenuItems::iterator i = std::find(
+			menuItems->begin(),
+			menuItems->end(),
+			selected);
 
-	// one icon per window
-	typedef std::map<Window, MenuItem *> WindowToItem;
-	WindowToItem windowToItem;
+		if (i != menuItems->end() && i != menuItems->begin()) {
+			menuItems->splice(menuItems->begin(), *menuItems, i);
+		}
+	}
 
-	IconMap *iconMap = &app->getSettings()->getIconMap();
+	reconcile(menuItems, forWindow);
 
-	// display workspaces
-	const Settings::WorkspaceDisplaySettings wsds =
-		app->getSettings()->getWorkspaceDisplaySettings();
-	WorkspaceLayout *wsl = WorkspaceLayout::getWorkspaceLayout(
-		app->getDisplay(),
-		wsds.preferredLayout);
+	return true;
+}
 
-	// clear windows and make sure all items have valid icons
-	{
-		MenuItems::iterator si = menuItems->end();
+/**
+ * Bring all configured menus up to date without touching the selection
+ */
+void Menu::prewarm() {
+	Settings::Menus *menus = &app->getSettings()->getMenus();
 
-		for (MenuItems::iterator i = menuItems->begin();
-				i != menuItems->end();
-				++i) {
-			Icon *icon;
+	for (Settings::Menus::iterator m = menus->begin();
+			m != menus->end();
+			++m) {
+		prewarmMenu(&(*m).second);
+	}
+}
 
-			if (!(icon = (*i)->getIcon())) {
-				if (!(icon = iconMap->getIconByName((*i)->getTitle()))) {
-					icon = iconMap->getMissingIcon((*i)->getTitle());
-				}
+/**
+ * Bring a single menu up to date; returns false if there is no such menu
+ *
+ * @param menuName - menu name
+ */
+bool Menu::prewarm(const std::string &menuName) {
+	MenuItems *items;
 
-				(*i)->setIcon(icon);
-			}
+	if (!(items = app->getSettings()->getMenu(menuName))) {
+		return false;
+	}
 
-			if (menuItems->oneIconPerWindow()) {
-				windowToItem[(*i)->getNextWindow()] = (*i);
+	prewarmMenu(items);
 
-				if (*i == selected) {
-					si = i;
-				}
-			}
+	return true;
+}
 
-			iconToItem[icon] = (*i);
-			(*i)->clearWindows();
-		}
+/**
+ * Bring menu items up to date while the menu isn't shown
+ *
+ * @param items - menu items
+ */
+void Menu::prewarmMenu(MenuItems *items) {
+	reconcile(items);
+}
 
-		// move menu item to the top when one icon per window is used
-		if (si != menuItems->end()) {
-			menuItems->erase(si);
-			menuItems->push_front(selected);
-		}
-	}
+/**
+ * Bring menu items up to date with the open windows; only windows that
+ * have changed since the last call are evaluated again, everything else
+ * stays where it is
+ *
+ * @param items - menu items
+ * @param forWindow - first window of a list of open windows that belong
+ *                    to the same application (optional)
+ */
+void Menu::reconcile(MenuItems *items, Window forWindow) {
+	ClientMap *clients = &app->getClientMap();
+
+	clients->update();
 
 	// get filter
 	std::string classFilter;
 
-	if (forWindow || menuItems->onlyFromActive()) {
-		Window w = forWindow ?
-			forWindow :
-			WindowManager::getActive(app->getDisplay());
-		XClassHint xch;
+	if (forWindow || items->onlyFromActive()) {
+		const ClientMap::Client *c = clients->getClient(
+			forWindow ? forWindow : clients->getActive());
 
-		if (w && XGetClassHint(app->getDisplay(), w, &xch)) {
-			classFilter = xch.res_class;
-
-			XFree(xch.res_name);
-			XFree(xch.res_class);
+		if (c) {
+			classFilter = c->className;
 		}
 	}
 
-	// assign windows to menu items; this is done by evaluating name, class
-	// and title of the windows since you just can't trust window IDs over time
-	{
-		WindowManager::WindowList wl(app->getDisplay());
+	// evaluate all windows if this menu has never been updated, if the
+	// change log doesn't reach back far enough or if the filter changed
+	bool rebuild = forWindow ||
+		!items->getSerial() ||
+		items->getSerial() < clients->getOldestSerial() ||
+		classFilter.compare(items->getClassFilter());
 
-		for (WindowManager::WindowList::iterator i = wl.begin();
-				i != wl.end();
-				++i) {
-			if (!WindowManager::isNormalWindow(app->getDisplay(), (*i))) {
-				continue;
-			}
+	items->setClassFilter(classFilter);
 
-			XClassHint xch;
+	// take filler icons off, they are always at the end
+	while (!items->empty() &&
+			isFiller(items->back())) {
+		deleteItem(items->back());
+		items->pop_back();
+	}
 
-			if (!XGetClassHint(app->getDisplay(), (*i), &xch)) {
-				continue;
-			}
+	Touched touched;
 
-			if (app->getSettings()->ignoreWindow(xch.res_name) ||
-					((forWindow || menuItems->onlyFromActive()) &&
-							classFilter.compare(xch.res_class))) {
-				XFree(xch.res_name);
-				XFree(xch.res_class);
+	if (rebuild) {
+		IconMap *iconMap = &app->getSettings()->getIconMap();
 
-				continue;
-			}
+		// make sure all sticky items have valid icons
+		for (MenuItems::iterator i = items->begin();
+				i != items->end();
+				++i) {
+			Icon *icon;
 
-			std::string windowTitle = WindowManager::getTitle(
-				app->getDisplay(),
-				(*i));
-
-			Icon *icon = iconMap->getIcon(
-				windowTitle,
-				xch.res_class,
-				xch.res_name);
-
-			// handle missing icons
-			if (!icon || icon->getType() == Icon::Missing) {
-				ArgbSurface *s;
-
-				if ((s = WindowManager::getIcon(app->getDisplay(), (*i)))) {
-					if (icon) {
-						icon->setSurface(s);
-						icon->setType(Icon::Window);
-					} else {
-						icon = iconMap->createIcon(
-							s,
-							xch.res_name,
-							Icon::Window);
-					}
-
-					iconMap->saveIcon(s, xch.res_name);
-					delete s;
-				} else if (!icon) {
-					icon = iconMap->getMissingIcon(xch.res_name);
+			if (!(icon = (*i)->getIcon())) {
+				if (!(icon = iconMap->getIconByName((*i)->getTitle()))) {
+					icon = iconMap->getMissingIcon((*i)->getTitle());
 				}
-			}
 
-			XFree(xch.res_name);
-			XFree(xch.res_class);
+				(*i)->setIcon(icon);
+			}
 
-			if (menuItems->oneIconPerWindow()) {
-				WindowToItem::iterator w;
-				MenuItem *item;
+			if (!items->oneIconPerWindow() &&
+					items->getIconToItem().find(icon) ==
+						items->getIconToItem().end()) {
+				items->getIconToItem()[icon] = (*i);
+			}
+		}
 
-				// try to use existing icon
-				if ((w = windowToItem.find((*i))) != windowToItem.end()) {
-					item = (*w).second;
+		// assign windows to menu items; this is done by evaluating
+		// name, class and title of the windows since you just can't
+		// trust window IDs over time
+		std::set<Window> seen;
 
-					// always get icon anew when reusing a window ID
-					item->setIcon(icon);
-				} else {
-					menuItems->push_back(
-						(item = new MenuItemWithWorkspaces(icon)));
-				}
+		for (ClientMap::Windows::const_iterator i =
+					clients->getWindows().begin();
+				i != clients->getWindows().end();
+				++i) {
+			const ClientMap::Client *c;
 
-				item->addWindow(app->getDisplay(), (*i));
-				item->setTitle(windowTitle);
+			if ((c = clients->getClient(*i))) {
+				assign(items, *c, classFilter, touched);
+				seen.insert(*i);
+			}
+		}
 
-				if (wsds.visible) {
-					MenuItemWithWorkspaces *w =
-						dynamic_cast<MenuItemWithWorkspaces *>(item);
+		// forget windows that are gone
+		MenuItems::WindowToItem::iterator i =
+			items->getWindowToItem().begin();
 
-					if (w) {
-						w->showWorkspace(
-							wsl,
-							wsds.workspaceColor,
-							wsds.windowColor);
-					}
+		while (i != items->getWindowToItem().end()) {
+			if (seen.find((*i).first) == seen.end()) {
+				(*i).second->removeWindow((*i).first);
+				touched.insert((*i).second);
+				items->getWindowToItem().erase(i++);
+			} else {
+				++i;
+			}
+		}
+	} else {
+		for (ClientMap::Changes::const_iterator i =
+					clients->getChangesSince(items->getSerial());
+				i != clients->getChanges().end();
+				++i) {
+			if ((*i).removed) {
+				MenuItems::WindowToItem::iterator w;
+
+				if ((w = items->getWindowToItem().find((*i).window)) !=
+						items->getWindowToItem().end()) {
+					(*w).second->removeWindow((*i).window);
+					touched.insert((*w).second);
+					items->getWindowToItem().erase(w);
 				}
 
 				continue;
 			}
 
-			// find existing icon or create a new one
-			{
-				IconToItem::iterator m;
+			const ClientMap::Client *c = clients->getClient((*i).window);
 
-				if ((m = iconToItem.find(icon)) != iconToItem.end()) {
-					(*m).second->addWindow(app->getDisplay(), (*i));
-				} else if (menuItems->includeWindows()) {
-					MenuItem *item = new MenuItem(icon);
-					item->addWindow(app->getDisplay(), (*i));
-					item->setTitle(windowTitle);
+			// skip window if it's gone or if there's a newer change
+			if (!c || c->serial != (*i).serial) {
+				continue;
+			}
 
-					iconToItem[icon] = item;
-					menuItems->push_back(item);
-				}
+			assign(items, *c, classFilter, touched);
+		}
+	}
+
+	items->setSerial(clients->getSerial());
+
+	// remove all menu items that have no windows and are not sticky
+	for (Touched::iterator i = touched.begin();
+			i != touched.end();
+			++i) {
+		if ((*i)->isSticky()) {
+			continue;
+		} else if ((*i)->hasWindows()) {
+			const ClientMap::Client *c = clients->getClient(
+				(*i)->getWindowInfos().front().window);
+
+			// first window may have changed
+			if (c) {
+				(*i)->setTitle(c->title);
 			}
+
+			continue;
+		}
+
+		MenuItems::IconToItem::iterator m;
+
+		if ((m = items->getIconToItem().find((*i)->getIcon())) !=
+				items->getIconToItem().end() &&
+				(*m).second == (*i)) {
+			items->getIconToItem().erase(m);
 		}
+
+		items->remove(*i);
+		deleteItem(*i);
 	}
 
-	// remove all menu items that have no windows and
-	// are not sticky
+	// workspace icons depend on the current workspace and need to
+	// be fetched again when the icon map has dropped them
 	{
-		MenuItems::iterator i = menuItems->begin();
+		const Settings::WorkspaceDisplaySettings wsds =
+			app->getSettings()->getWorkspaceDisplaySettings();
+		const WorkspaceIconMap *wim =
+			&app->getSettings()->getWorkspaceIconMap();
+		WorkspaceLayout *wsl = WorkspaceLayout::getWorkspaceLayout(
+			app->getDisplay(),
+			wsds.preferredLayout);
 
-		while (i != menuItems->end()) {
-			if (!(*i)->isSticky() &&
-					!(*i)->hasWindows()) {
-				delete(*i);
-				i = menuItems->erase(i);
-			} else {
-				++i;
+		if (wsds.visible && items->oneIconPerWindow()) {
+			bool all = wsl->getSerial() != items->getLayoutSerial();
+
+			for (MenuItems::iterator i = items->begin();
+					i != items->end();
+					++i) {
+				MenuItemWithWorkspaces *w;
+
+				if (all ||
+						((w = dynamic_cast<MenuItemWithWorkspaces *>(*i)) &&
+							w->isWorkspaceIconOutdated(wim))) {
+					showWorkspace(*i);
+				}
 			}
 		}
+
+		items->setLayoutSerial(wsl->getSerial());
 	}
 
 	// fill menu with dummy icons if there is a minimum number
 	{
 		int m = app->getSettings()->getMinimumNumber();
 
-		if (m > 0 && menuItems->size() < m) {
-			for (m -= menuItems->size(); m--;) {
-				menuItems->push_back(new MenuItem(
+		if (m > 0 && items->size() < static_cast<unsigned int>(m)) {
+			IconMap *iconMap = &app->getSettings()->getIconMap();
+
+			for (m -= items->size(); m--;) {
+				items->push_back(new MenuItem(
 					iconMap->getFillerIcon()));
 			}
 		}
 	}
-
-	return true;
 }
 
 /**
@@ -299,6 +349,8 @@ void Menu::execute(Settings::Action a) {
 		return;
 	}
 
+	RequestCounter::Scope scope(app->getDisplay(), RequestCounter::Activate);
+
 	// if there are no windows only Launch is allowed
 	if (!selected->hasWindows()) {
 		if (a != Settings::Launch &&
@@ -313,27 +365,15 @@ void Menu::execute(Settings::Action a) {
 
 	switch (a) {
 	case Settings::Launch: {
-		std::string cmd = selected->getCommand();
-
-		// substitute $WID with window ID
-		{
-			std::string::size_type p;
-
-			if ((p = cmd.find("$WID")) != std::string::npos) {
-				std::ostringstream oss;
-
-				oss << cmd.substr(0, p) <<
-					"0x" <<
-					std::hex << WindowManager::getClientWindow(
-						app->getDisplay(),
-						getWindowBelowCursor()) <<
-					cmd.substr(p+4);
-
-				cmd = oss.str();
-			}
-		}
-
-		run(cmd);
+		const Command &cmd = selected->getParsedCommand();
+
+		run(
+			cmd,
+			cmd.usesWindow() ?
+				WindowManager::getClientWindow(
+					app->getDisplay(),
+					getWindowBelowCursor()) :
+				0);
 	}
 	break;
 	case Settings::ShowWindows:
@@ -372,30 +412,183 @@ std::string Menu::getItemTitle() const {
 };
 
 /**
- * Run some command
+ * Assign window to a menu item, reusing the item it is already in
+ * whenever possible to keep the order of windows stable
  *
- * @param command - command to execute
+ * @param items - menu items
+ * @param c - client window
+ * @param classFilter - only accept windows of this class if not empty
+ * @param touched - items that lost a window
  */
-int Menu::run(std::string command) const {
-	int pid = fork();
+void Menu::assign(
+	MenuItems *items,
+	const ClientMap::Client &c,
+	const std::string &classFilter,
+	Touched &touched) {
+	MenuItems::WindowToItem *wti = &items->getWindowToItem();
+	MenuItems::WindowToItem::iterator w = wti->find(c.window);
+	MenuItem *old = w != wti->end() ? (*w).second : 0;
+	MenuItem *item = 0;
+
+	if (c.normal &&
+			!app->getSettings()->ignoreWindow(c.name) &&
+			(classFilter.empty() || !classFilter.compare(c.className))) {
+		Icon *icon = getIcon(c);
+
+		if (items->oneIconPerWindow()) {
+			if (!(item = old)) {
+				items->push_back(
+					(item = new MenuItemWithWorkspaces(icon)));
+			}
+
+			// always get icon anew when reusing a window ID
+			item->setIcon(icon);
+		} else {
+			MenuItems::IconToItem::iterator m;
+
+			if ((m = items->getIconToItem().find(icon)) !=
+					items->getIconToItem().end()) {
+				item = (*m).second;
+			} else if (items->includeWindows()) {
+				items->push_back((item = new MenuItem(icon)));
+				items->getIconToItem()[icon] = item;
+			}
+		}
+	}
 
-	if (pid < 0) {
-		throw std::runtime_error("fork failed");
-	} else if (pid) {
-		return pid;
+	if (old && old != item) {
+		old->removeWindow(c.window);
+		touched.insert(old);
+		wti->erase(w);
 	}
 
-	char *shell = getenv("SHELL");
+	if (!item) {
+		return;
+	}
 
-	if (!shell) {
-		shell = const_cast<char *>("/bin/sh");
+	if (old != item) {
+		item->addWindow(c.window, c.attributes);
+		(*wti)[c.window] = item;
+	} else {
+		item->updateWindow(c.window, c.attributes);
 	}
 
-	setsid();
-	execl(shell, shell, "-c", command.c_str(), NULL);
+	// items that were created for windows are named after their
+	// first window
+	if (!item->isSticky() &&
+			item->getWindowInfos().front().window == c.window) {
+		item->setTitle(c.title);
+	}
+
+	if (items->oneIconPerWindow() &&
+			app->getSettings()->getWorkspaceDisplaySettings().visible) {
+		showWorkspace(item);
+	}
+}
 
-	throw std::runtime_error("exec failed");
+/**
+ * Return icon for some client window
+ *
+ * @param c - client window
+ */
+Icon *Menu::getIcon(const ClientMap::Client &c) {
+	IconMap *iconMap = &app->getSettings()->getIconMap();
+	Icon *icon = iconMap->getIcon(
+		c.title,
+		c.className,
+		c.name);
+
+	// handle missing icons
+	if (!icon || icon->getType() == Icon::Missing) {
+		ArgbSurface *s;
+
+		if ((s = WindowManager::getIcon(app->getDisplay(), c.window))) {
+			if (icon) {
+				icon->setSurface(s);
+				icon->setType(Icon::Window);
+			} else {
+				icon = iconMap->createIcon(
+					s,
+					c.name,
+					Icon::Window);
+			}
+
+			iconMap->saveIcon(s, c.name);
+			delete s;
+		} else if (!icon) {
+			icon = iconMap->getMissingIcon(c.name);
+		}
+	}
+
+	return icon;
+}
+
+/**
+ * Update workspace icon of a menu item
+ *
+ * @param item - menu item
+ */
+void Menu::showWorkspace(MenuItem *item) {
+	MenuItemWithWorkspaces *w =
+		dynamic_cast<MenuItemWithWorkspaces *>(item);
+
+	if (!w) {
+		return;
+	}
+
+	const Settings::WorkspaceDisplaySettings wsds =
+		app->getSettings()->getWorkspaceDisplaySettings();
+
+	w->showWorkspace(
+		&app->getSettings()->getWorkspaceIconMap(),
+		WorkspaceLayout::getWorkspaceLayout(
+			app->getDisplay(),
+			wsds.preferredLayout),
+		wsds.workspaceColor,
+		wsds.windowColor);
+}
+
+/**
+ * Delete menu item; menu items are shared by all menus, so every menu
+ * that has the item selected needs to forget it
+ *
+ * @param item - menu item
+ */
+void Menu::deleteItem(MenuItem *item) {
+	deselect(item);
+
+	if (app->getWindowPool()) {
+		app->getWindowPool()->deselect(item);
+	}
+
+	delete item;
+}
+
+/**
+ * Returns true if item is a filler
+ *
+ * @param item - menu item
+ */
+bool Menu::isFiller(MenuItem *item) const {
+	return !item->isSticky() &&
+		!item->hasWindows() &&
+		item->getIcon() &&
+		item->getIcon()->getType() == Icon::Filler;
+}
+
+/**
+ * Run some command; returns process id of child or -1 on error
+ *
+ * @param command - command to execute
+ * @param w - window that replaces $WID (optional)
+ */
+int Menu::run(const Command &command, Window w) const {
+	try {
+		return command.run(w);
+	} catch (std::exception &e) {
+		std::cerr << "error: cannot run \"" << command.getLine() <<
+			"\": " << e.what() << std::endl;
+	}
 
-	// make compiler happy
-	return 0;
+	return -1;
 }
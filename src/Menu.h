@@ -5,8 +5,10 @@
 #include "Settings.h"
 #include "Icon.h"
 #include "MenuItems.h"
+#include "ClientMap.h"
 
 #include <string>
+#include <set>
 
 namespace PieDock {
 class Menu {
@@ -25,7 +27,22 @@ public:
 	inline const std::string &getName() const {
 		return name;
 	}
+	inline void setMenuItems(MenuItems *m) {
+		selected = 0;
+		menuItems = m;
+	}
+	inline void forgetMenuItems() {
+		selected = 0;
+		menuItems = 0;
+	}
+	inline void deselect(MenuItem *item) {
+		if (selected == item) {
+			selected = 0;
+		}
+	}
 	virtual bool update(std::string, Window = 0);
+	virtual void prewarm();
+	virtual bool prewarm(const std::string &);
 	virtual void draw(int, int) {}
 	virtual bool change(Settings::Action = Settings::Launch);
 	virtual void execute(Settings::Action = Settings::Launch);
@@ -41,15 +58,26 @@ protected:
 	inline MenuItems *getMenuItems() const {
 		return menuItems;
 	}
-	virtual int run(std::string) const;
+	virtual int run(const Command &, Window = 0) const;
+	virtual void reconcile(MenuItems *, Window = 0);
+	virtual void prewarmMenu(MenuItems *);
 
 private:
+	typedef std::set<MenuItem *> Touched;
+
 	Application *app;
 	MenuItem *selected;
 	MenuItems *menuItems;
 	MenuItems openWindows;
 	Window windowBelowCursor;
 	std::string name;
+
+	void assign(MenuItems *, const ClientMap::Client &,
+		const std::string &, Touched &);
+	Icon *getIcon(const ClientMap::Client &);
+	void showWorkspace(MenuItem *);
+	bool isFiller(MenuItem *) const;
+	void deleteItem(MenuItem *);
 };
 }
 
@@ -3,6 +3,7 @@
 
 #include "WindowStack.h"
 #include "Icon.h"
+#include "Command.h"
 
 namespace PieDock {
 class MenuItem : public WindowStack {
@@ -17,10 +18,13 @@ public:
 		title = t;
 	}
 	virtual inline const std::string &getCommand() const {
+		return command.getLine();
+	}
+	virtual inline const Command &getParsedCommand() const {
 		return command;
 	}
 	virtual inline void setCommand(std::string c) {
-		command = c;
+		command = Command(c);
 	}
 	virtual inline Icon *getIcon() const {
 		return icon;
@@ -37,7 +41,7 @@ public:
 
 private:
 	std::string title;
-	std::string command;
+	Command command;
 	Icon *icon;
 	bool sticky;
 };
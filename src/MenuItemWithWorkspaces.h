@@ -3,31 +3,26 @@
 
 #include "MenuItem.h"
 #include "WorkspaceLayout.h"
+#include "WorkspaceIconMap.h"
 
 namespace PieDock {
 class MenuItemWithWorkspaces : public MenuItem {
 public:
 	MenuItemWithWorkspaces(Icon *);
-	virtual ~MenuItemWithWorkspaces();
+	virtual ~MenuItemWithWorkspaces() {}
 	virtual inline Icon *getIcon() const {
-		return useWorkspaceIcon ? workspaceIcon : MenuItem::getIcon();
+		return workspaceIcon ? workspaceIcon : MenuItem::getIcon();
 	}
-	virtual void showWorkspace(WorkspaceLayout *, unsigned int, unsigned int);
-
-protected:
-	virtual void freeWorkspaceIcon();
+	inline bool isWorkspaceIconOutdated(
+			const WorkspaceIconMap *wim) const {
+		return workspaceIcon && !wim->isValid(serial);
+	}
+	virtual void showWorkspace(WorkspaceIconMap *, WorkspaceLayout *,
+		unsigned int, unsigned int);
 
 private:
-	typedef struct {
-		int x;
-		int y;
-		int width;
-		int height;
-	} Geometry;
-
 	Icon *workspaceIcon;
-	bool useWorkspaceIcon;
-	Geometry cachedGeometry;
+	unsigned long serial;
 };
 }
 
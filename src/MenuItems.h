@@ -4,11 +4,21 @@
 #include "MenuItem.h"
 
 #include <list>
+#include <map>
+#include <string>
 
 namespace PieDock {
 class MenuItems : public std::list<MenuItem *> {
 public:
-	MenuItems() : windows(false), one(false), only(false) {}
+	typedef std::map<Window, MenuItem *> WindowToItem;
+	typedef std::map<Icon *, MenuItem *> IconToItem;
+
+	MenuItems() :
+		windows(false),
+		one(false),
+		only(false),
+		serial(0),
+		layoutSerial(0) {}
 	virtual ~MenuItems() {}
 	inline const bool &includeWindows() const {
 		return windows;
@@ -28,11 +38,40 @@ public:
 	inline void setOnlyFromActive(bool o) {
 		only = o;
 	}
+	inline WindowToItem &getWindowToItem() {
+		return windowToItem;
+	}
+	inline IconToItem &getIconToItem() {
+		return iconToItem;
+	}
+	inline const unsigned long &getSerial() const {
+		return serial;
+	}
+	inline void setSerial(unsigned long s) {
+		serial = s;
+	}
+	inline const unsigned long &getLayoutSerial() const {
+		return layoutSerial;
+	}
+	inline void setLayoutSerial(unsigned long s) {
+		layoutSerial = s;
+	}
+	inline const std::string &getClassFilter() const {
+		return classFilter;
+	}
+	inline void setClassFilter(std::string c) {
+		classFilter = c;
+	}
 
 private:
 	bool windows;
 	bool one;
 	bool only;
+	WindowToItem windowToItem;
+	IconToItem iconToItem;
+	unsigned long serial;
+	unsigned long layoutSerial;
+	std::string classFilter;
 };
 }
 
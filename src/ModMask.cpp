@@ -5,6 +5,7 @@
  * http://www.opensource.org/licenses/mit-license.php
  */
 #include "ModMask.h"
+#include "CacheFile.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -162,3 +163,24 @@ unsigned int ModMask::getModMaskFor(const char *name) {
 
 	return 0;
 }
+
+/**
+ * Return hash over the modifier mapping; settings that were resolved
+ * with a different mapping need to be resolved again
+ */
+uint64_t ModMask::getHash() const {
+	uint64_t h = CacheFile::hash(0, 0);
+
+	for (int i = 0; modKey && i < modKeyCount; ++i) {
+		int mask = modKey[i].xlat ? modKey[i].xlat->mask : 0;
+
+		h = CacheFile::hash(&modKey[i].code, sizeof(modKey[i].code), h);
+		h = CacheFile::hash(&mask, sizeof(mask), h);
+
+		if (modKey[i].type) {
+			h = CacheFile::hash(modKey[i].type, strlen(modKey[i].type), h);
+		}
+	}
+
+	return h;
+}
@@ -9,12 +9,15 @@
 
 #include <X11/Xlib.h>
 
+#include <stdint.h>
+
 namespace PieDock {
 class ModMask {
 public:
 	ModMask(Display *);
 	virtual ~ModMask();
 	unsigned int getModMaskFor(const char *);
+	uint64_t getHash() const;
 
 private:
 	struct XlatEntry {
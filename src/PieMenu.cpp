@@ -1,4 +1,5 @@
 #include "PieMenu.h"
+#include "Timings.h"
 
 #include <math.h>
 
@@ -20,15 +21,21 @@ const double PieMenu::turnSteps[] = {
 	.1,
 	.0
 };
+const double PieMenu::zoomSpeed = 200.0;
+const double PieMenu::twistPerPixel = .025;
+const double PieMenu::turnDuration = .1;
 
 /**
  * Initialize menu
  *
  * @param a - application
  * @param s - surface to draw menu into
+ * @param c - settings for a menu without application (optional);
+ *            such a menu can only be drawn
  */
-PieMenu::PieMenu(Application *a, Surface &s) :
+PieMenu::PieMenu(Application *a, Surface &s, Settings *c) :
 	Menu(a),
+	settings(c),
 	blender(s),
 	size((s.getWidth() < s.getHeight() ? s.getWidth() : s.getHeight())),
 	maxRadius((size-static_cast<int>(.3 * size)) >> 1),
@@ -36,9 +43,11 @@ PieMenu::PieMenu(Application *a, Surface &s) :
 	twist(.0),
 	centerX(s.getWidth() >> 1),
 	centerY(s.getHeight() >> 1),
-	turnStack(0) {
+	zoomFrom(radius),
+	zoomStart(-1),
+	turning(false) {
 #ifdef HAVE_XRENDER
-	if (a->getSettings()->useCompositing()) {
+	if (getSettings()->useCompositing()) {
 		blender.setCompositing(true);
 	}
 #endif
@@ -55,18 +64,119 @@ PieMenu::PieMenu(Application *a, Surface &s) :
  * @param w - window id (optional)
  */
 bool PieMenu::update(std::string n, Window w) {
-	radius = static_cast<int>(
-		getApp()->getSettings()->getStartRadius() * maxRadius);
-	twist = -.05 * static_cast<double>((maxRadius-radius) >> 1);
+	restart();
+
+	return Menu::update(n, w);
+}
+
+/**
+ * Zoom and rotate into appearance again
+ */
+void PieMenu::restart() {
+	zoomFrom = radius = static_cast<int>(
+		getSettings()->getStartRadius() * maxRadius);
+	twist = -twistPerPixel * static_cast<double>(maxRadius-radius);
+	zoomStart = -1;
+	turning = false;
 
 	invalidate();
+}
+
+/**
+ * Advance animations to the given point in time; zooming and spinning
+ * depend on elapsed time only, not on the number of frames drawn
+ *
+ * @param t - monotonic time in seconds
+ */
+void PieMenu::animate(double t) {
+	// zoom and rotate into appearance
+	if (radius < maxRadius) {
+		if (zoomStart < 0) {
+			zoomStart = t;
+		}
+
+		int r = zoomFrom + static_cast<int>(zoomSpeed * (t - zoomStart));
+
+		if (r > maxRadius) {
+			r = maxRadius;
+		}
 
-	if (turnStack) {
-		delete turnStack;
-		turnStack = 0;
+		twist = getValidAngle(
+			twist + twistPerPixel * static_cast<double>(r - radius));
+		radius = r;
+	} else if (turning) {
+		if (turnStart < 0) {
+			turnStart = t;
+		}
+
+		double p = (t - turnStart) / turnDuration;
+		double d = turnDistance;
+
+		if (p < 1.0) {
+			d *= getTurnProgress(p);
+		} else {
+			turning = false;
+		}
+
+		twist = getValidAngle(twist + d - turnDone);
+		turnDone = d;
 	}
+}
 
-	return Menu::update(n, w);
+/**
+ * Bring menu up to date and resize its icons for zooming into
+ * appearance around the cursor
+ *
+ * @param items - menu items
+ */
+void PieMenu::prewarmMenu(MenuItems *items) {
+	Menu::prewarmMenu(items);
+
+	const int numberOfIcons = items->size();
+
+	if (!numberOfIcons) {
+		return;
+	}
+
+	ArgbSurfaceSizeMap *activeIndicatorSizeMap =
+		getSettings()->getActiveIndicator().getSizeMap();
+	const int startRadius = static_cast<int>(
+		getSettings()->getStartRadius() * maxRadius);
+
+	// with the cursor in the center all icons have the same size
+	// which is the smaller one of the maximum icon size and the
+	// cell size, see draw(); animate() may hit any radius between
+	// the start radius and the final one depending on when frames
+	// are drawn, so every size of that range is prepared; draw()
+	// rounds sizes to even numbers so there are only a few
+	for (int r = startRadius, lastSize = -1; r <= maxRadius; ++r) {
+		double cellSize = M_PI * (r << 1) / numberOfIcons * .75;
+		double maxIconSize = .8 * r;
+		const int size = static_cast<int>(
+			cellSize < maxIconSize ? cellSize : maxIconSize) >> 1 << 1;
+
+		if (size == lastSize) {
+			continue;
+		}
+
+		lastSize = size;
+
+		for (MenuItems::iterator i = items->begin();
+				i != items->end();
+				++i) {
+			Icon *icon;
+
+			if (!(icon = (*i)->getIcon()) ||
+					!icon->getSurface(size, size) ||
+					!(*i)->hasWindows()) {
+				continue;
+			}
+
+			(activeIndicatorSizeMap ?
+				activeIndicatorSizeMap :
+				icon)->getSurface(size/3, size/3);
+		}
+	}
 }
 
 /**
@@ -77,7 +187,7 @@ bool PieMenu::update(std::string n, Window w) {
  */
 bool PieMenu::isObsolete(int x, int y) {
 	// menu is always obsolete while animating
-	if (radius < maxRadius || turnStack) {
+	if (isAnimating()) {
 		return true;
 	}
 
@@ -99,6 +209,7 @@ bool PieMenu::isObsolete(int x, int y) {
  * @param y - y coordinate of cursor position within target surface
  */
 void PieMenu::draw(int x, int y) {
+	Timings::Span span(Timings::Draw);
 	int numberOfIcons = getMenuItems()->size();
 	int closestIcon = 0;
 	bool cursorNearCenter = false;
@@ -120,6 +231,7 @@ void PieMenu::draw(int x, int y) {
 
 	// calculate positions and sizes
 	{
+		Timings::Span layout(Timings::Layout);
 		double circumference = M_PI * (radius << 1);
 		double pixelsPerRadian = tau / circumference;
 		int centeredY = y-centerY;
@@ -137,7 +249,7 @@ void PieMenu::draw(int x, int y) {
 				centeredY * centeredY +
 				centeredX * centeredX);
 			double infieldRadius = radius>>1;
-			double z = getApp()->getSettings()->getZoomModifier();
+			double z = getSettings()->getZoomModifier();
 			double f = cursorRadius/infieldRadius * z;
 
 			if (f > z) {
@@ -285,11 +397,11 @@ void PieMenu::draw(int x, int y) {
 	// draw icons
 	{
 		const ActiveIndicator *activeIndicator =
-			&getApp()->getSettings()->getActiveIndicator();
+			&getSettings()->getActiveIndicator();
 		ArgbSurfaceSizeMap *activeIndicatorSizeMap =
 			activeIndicator->getSizeMap();
 		const bool selectInCenter =
-			getApp()->getSettings()->getCenterAction() ==
+			getSettings()->getCenterAction() ==
 				Settings::CenterNearestIcon ? true : false;
 		int n = 0;
 
@@ -312,9 +424,9 @@ void PieMenu::draw(int x, int y) {
 			if (n == closestIcon &&
 					(!cursorNearCenter || selectInCenter)) {
 				setSelected(*i);
-				opacity = getApp()->getSettings()->getFocusedAlpha();
+				opacity = getSettings()->getFocusedAlpha();
 			} else {
-				opacity = getApp()->getSettings()->getUnfocusedAlpha();
+				opacity = getSettings()->getUnfocusedAlpha();
 			}
 
 			blender.blend(
@@ -345,30 +457,6 @@ void PieMenu::draw(int x, int y) {
 			}
 		}
 	}
-
-	// zoom and rotate into appearance
-	if (radius < maxRadius) {
-		if ((radius += 2) > maxRadius) {
-			radius = maxRadius;
-		}
-
-		if ((twist += .05) > tau) {
-			twist -= tau;
-		}
-	} else if (turnStack) {
-		if (*turnBy == .0) {
-			delete turnStack;
-			turnStack = 0;
-		} else {
-			twist += *(turnBy++);
-
-			if (twist > tau) {
-				twist -= tau;
-			} else if (twist < 0) {
-				twist += tau;
-			}
-		}
-	}
 }
 
 /**
@@ -398,27 +486,44 @@ void PieMenu::turn(int c) {
 		static_cast<double>(getMenuItems()->size()) *
 		static_cast<double>(c);
 
-	if (turnStack) {
-		for (; *turnBy != 0.0; ++turnBy) {
-			f += *turnBy;
-		}
-
-		delete turnStack;
+	// add what's left of a running turn
+	if (turning) {
+		f += turnDistance - turnDone;
 	}
 
-	f /= 4.5; // turn steps
+	turning = true;
+	turnStart = -1;
+	turnDistance = f;
+	turnDone = 0;
+}
+
+/**
+ * Return how much of a turn should be done at some point of its
+ * duration; turnSteps is used as an easing curve
+ *
+ * @param p - elapsed part of turn duration from 0 to 1
+ */
+double PieMenu::getTurnProgress(double p) const {
+	double total = 0;
+	double done = 0;
+	int steps = 0;
+
+	for (const double *s = turnSteps; *s != .0; ++s, ++steps) {
+		total += *s;
+	}
 
-	turnBy = turnStack = new double[sizeof(turnSteps) / sizeof(double)];
+	double position = p * static_cast<double>(steps);
+	int n = static_cast<int>(position);
 
-	double *t = turnStack;
-	const double *s = turnSteps;
+	for (int i = 0; i < n && i < steps; ++i) {
+		done += turnSteps[i];
+	}
 
-	for (; ; ++t, ++s) {
-		*t = f*(*s);
-		if (*s == 0.0) {
-			break;
-		}
+	if (n < steps) {
+		done += turnSteps[n] * (position - static_cast<double>(n));
 	}
+
+	return done / total;
 }
 
 /**
@@ -13,7 +13,7 @@
 namespace PieDock {
 class PieMenu : public Menu {
 public:
-	PieMenu(Application *, Surface &);
+	PieMenu(Application *, Surface &, Settings * = 0);
 	virtual ~PieMenu() {}
 	inline const bool cursorInCenter() const {
 		return (getSelected() == 0);
@@ -27,7 +27,12 @@ public:
 	inline void invalidate() {
 		lastX = lastY = -1;
 	}
+	inline bool isAnimating() const {
+		return radius < maxRadius || turning;
+	}
 	virtual bool update(std::string = "", Window = 0);
+	virtual void restart();
+	virtual void animate(double);
 	virtual bool isObsolete(int, int);
 	virtual void draw(int, int);
 	virtual void turn(double);
@@ -59,11 +64,16 @@ protected:
 	inline virtual double getValidAngle(double a) {
 		return fmod(a + tau, tau);
 	}
+	virtual void prewarmMenu(MenuItems *);
 
 private:
 	static const double tau;
 	static const double turnSteps[];
+	static const double zoomSpeed;
+	static const double twistPerPixel;
+	static const double turnDuration;
 
+	Settings *settings;
 	Blender blender;
 	int size;
 	int maxRadius;
@@ -73,8 +83,22 @@ private:
 	int centerY;
 	int lastX;
 	int lastY;
-	double *turnStack;
-	double *turnBy;
+	int zoomFrom;
+	double zoomStart;
+	bool turning;
+	double turnStart;
+	double turnDistance;
+	double turnDone;
+
+	double getTurnProgress(double) const;
+
+	/**
+	 * Return current settings; always asks the application since
+	 * settings are replaced on reload
+	 */
+	inline Settings *getSettings() const {
+		return getApp() ? getApp()->getSettings() : settings;
+	}
 };
 }
 
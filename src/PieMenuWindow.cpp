@@ -1,6 +1,9 @@
 #include "PieMenuWindow.h"
 #include "WindowManager.h"
 #include "Hotspot.h"
+#include "FrameScheduler.h"
+#include "Timings.h"
+#include "RequestCounter.h"
 
 #include <stdexcept>
 
@@ -10,16 +13,22 @@ using namespace PieDock;
  * Initialize this window
  *
  * @param a - Application object
+ * @param s - screen number, if not given the default screen (optional)
  */
-PieMenuWindow::PieMenuWindow(Application &a) :
-		TransparentWindow(a),
+PieMenuWindow::PieMenuWindow(Application &a, int s) :
+		TransparentWindow(a, s),
 		menu(&a, *getCanvas()),
+		pointer(a.getDisplay(), RootWindow(a.getDisplay(), getScreen())),
+		windowX(0),
+		windowY(0),
+		textCanvas(0),
 		text(0),
-		textCanvas(0) {
+		titles(MaximumTitles) {
 	XSelectInput(
 		getApp()->getDisplay(),
 		getWindow(),
 		LeaveWindowMask |
+		PointerMotionMask |
 		ButtonReleaseMask |
 		ButtonPressMask |
 		KeyPressMask |
@@ -39,12 +48,6 @@ PieMenuWindow::~PieMenuWindow() {
 		XFreePixmap(getApp()->getDisplay(), textCanvas);
 		delete text;
 	}
-
-	for (CartoucheMap::iterator i = cartoucheMap.begin();
-			i != cartoucheMap.end();
-			++i) {
-		delete i->second;
-	}
 }
 
 /**
@@ -71,20 +74,34 @@ bool PieMenuWindow::appear(std::string n, PieMenuWindow::Placement p) {
  * (Re-)Draw contents
  */
 void PieMenuWindow::draw() {
-	Hotspot p(getApp()->getDisplay(), getWindow());
+	// cursor position is tracked from motion events to avoid
+	// querying the pointer for every frame
+	int x = pointer.getRootX() - windowX;
+	int y = pointer.getRootY() - windowY;
+
+	menu.animate(FrameScheduler::now());
 
-	if (!menu.isObsolete(p.getX(), p.getY())) {
+	if (!menu.isObsolete(x, y)) {
 		return;
 	}
 
-	clear();
-	menu.draw(p.getX(), p.getY());
+	Trace::nextFrame();
+	Timings::Span span(Timings::Frame);
 
-	if (!getApp()->getSettings()->getShowTitle()) {
-		update();
-	} else {
-		updateWithText();
+	{
+		RequestCounter::Scope scope(
+			getApp()->getDisplay(),
+			RequestCounter::Draw);
+
+		clear();
+		menu.draw(x, y);
+
+		if (getApp()->getSettings()->getShowTitle()) {
+			drawTitle();
+		}
 	}
+
+	update();
 }
 
 /**
@@ -94,41 +111,41 @@ void PieMenuWindow::draw() {
  * @param event - X event
  */
 bool PieMenuWindow::processEvent(XEvent &event) {
+	if (pointer.processEvent(event)) {
+		return true;
+	}
+
 	switch (event.type) {
 	case LeaveNotify:
+		// activating and releasing the passive grabs of the
+		// triggers generate crossing events, too
 		if (event.xany.window == getWindow() &&
+				event.xcrossing.mode == NotifyNormal &&
 				!getApp()->getSettings()->isFitts()) {
 			hide();
 			return false;
 		}
 		break;
 	case ButtonRelease: {
-		Settings::ButtonFunctions bf =
-			getApp()->getSettings()->getButtonFunctions(
-				menu.getName(),
-				menu.getSelected());
-
-		for (Settings::ButtonFunctions::iterator i = bf.begin();
-				i != bf.end();
-				++i)
-			if ((*i).button == event.xbutton.button) {
-				return performAction((*i).action);
-			}
+		Settings::Action a = getApp()->getSettings()->getButtonAction(
+			menu.getName(),
+			menu.getSelected(),
+			event.xbutton.button);
+
+		if (a != Settings::NoAction) {
+			return performAction(a);
+		}
 	}
 	break;
 	case KeyPress:
 	case KeyRelease: {
-		Settings::KeyFunctions *kf =
-			&getApp()->getSettings()->getKeyFunctions();
-
-		for (Settings::KeyFunctions::iterator i = kf->begin();
-				i != kf->end();
-				++i)
-			if (event.type == (*i).eventType &&
-					XKeysymToKeycode(event.xkey.display, (*i).keySym) ==
-					event.xkey.keycode) {
-				return performAction((*i).action);
-			}
+		Settings::Action a = getApp()->getSettings()->getKeyAction(
+			event.xkey.keycode,
+			event.type);
+
+		if (a != Settings::NoAction) {
+			return performAction(a);
+		}
 	}
 	break;
 	}
@@ -194,21 +211,27 @@ bool PieMenuWindow::performAction(Settings::Action action) {
  * @param p - where to show (optional)
  */
 void PieMenuWindow::show(PieMenuWindow::Placement p) {
+	RequestCounter::Scope scope(
+		getApp()->getDisplay(),
+		RequestCounter::Activate);
+
 	if (getApp()->getSettings()->isFitts() ||
 			getApp()->getSettings()->getKeyFunctions().size()) {
+		RequestCounter::roundTrip();
 		XGrabKeyboard(
 			getApp()->getDisplay(),
-			DefaultRootWindow(getApp()->getDisplay()),
+			RootWindow(getApp()->getDisplay(), getScreen()),
 			true,
 			GrabModeAsync,
 			GrabModeAsync,
 			CurrentTime);
 
+		RequestCounter::roundTrip();
 		XGrabPointer(
 			getApp()->getDisplay(),
-			DefaultRootWindow(getApp()->getDisplay()),
+			RootWindow(getApp()->getDisplay(), getScreen()),
 			true,
-			ButtonPressMask | ButtonReleaseMask,
+			ButtonPressMask | ButtonReleaseMask | PointerMotionMask,
 			GrabModeAsync,
 			GrabModeAsync,
 			None,
@@ -217,6 +240,7 @@ void PieMenuWindow::show(PieMenuWindow::Placement p) {
 	}
 
 	place(p);
+	pointer.start();
 	TransparentWindow::show();
 }
 
@@ -224,140 +248,143 @@ void PieMenuWindow::show(PieMenuWindow::Placement p) {
  * Hide window
  */
 void PieMenuWindow::hide() {
+	RequestCounter::Scope scope(
+		getApp()->getDisplay(),
+		RequestCounter::Activate);
+
 	if (getApp()->getSettings()->isFitts() ||
 			getApp()->getSettings()->getKeyFunctions().size()) {
 		XUngrabPointer(getApp()->getDisplay(), CurrentTime);
 		XUngrabKeyboard(getApp()->getDisplay(), CurrentTime);
 	}
 
+	pointer.stop();
 	TransparentWindow::hide();
 }
 
 /**
- * Update window having text
+ * Draw title of selected item
  */
-void PieMenuWindow::updateWithText() {
-	std::string title = menu.getItemTitle();
+void PieMenuWindow::drawTitle() {
+	const std::string &title = menu.getItemTitle();
 
 	if (title.empty()) {
-		update();
 		return;
 	}
 
-	if (!textCanvas) {
-		// since Xft requires a Drawable, there needs to be this
-		// detour through a Pixmap
-		if (!(textCanvas = XCreatePixmap(
-				getApp()->getDisplay(),
-				getWindow(),
-				getWidth(),
-				getHeight(),
-				getCanvas()->getResource()->depth)) || !(text = new Text(
-						getApp()->getDisplay(),
-						textCanvas,
-						getCanvas()->getVisual(),
-						getApp()->getSettings()->getTitleFont()))) {
-			throw std::runtime_error("out of memory");
-		}
-	}
+	// font and cartouche settings don't need to be part of the key
+	// because windows are recreated when they change
+	Title *t;
 
-	Text::Metrics m;
+	if (!(t = titles.get(title))) {
+		t = titles.put(title, createTitle(title));
+	}
 
-	// shorten title string until it fits inside the circle
-	for (int w = static_cast<int>((getWidth() - .3 * getWidth()) * .525321989);
-			title.length();) {
-		Text::Metrics p = text->getMetrics(title);
+	menu.getBlender()->blend(
+		*t,
+		(getWidth() - t->getWidth()) >> 1,
+		(getHeight() - t->getHeight()) >> 1,
+		Blender::Opaque);
+}
 
-		if (p.getWidth() < w) {
-			m = p;
-			break;
-		}
+/**
+ * Render title into a new surface
+ *
+ * @param s - title
+ */
+Title *PieMenuWindow::createTitle(const std::string &s) {
+	Timings::Span span(Timings::TextRender);
 
-		title.erase(--title.end());
+	if (!text) {
+		createText();
 	}
 
-	int r = getApp()->getSettings()->getCartoucheSettings().cornerRadius;
+	const Settings::CartoucheSettings &cs =
+		getApp()->getSettings()->getCartoucheSettings();
+
+	// shorten title so it fits inside the circle
+	std::string title = text->fit(
+		s,
+		static_cast<int>((getWidth() - .3 * getWidth()) * .525321989));
+	Text::Metrics m = text->getMetrics(title);
 
 	// text should have always the same height to avoid flickering
-	{
-		Text::Metrics p = text->getMetrics("Ag");
-		m.setY(p.getY() + (r >> 1));
-		m.setHeight(p.getHeight());
+	m.setY(text->getLineMetrics().getY() + (cs.cornerRadius >> 1));
+	m.setHeight(text->getLineMetrics().getHeight());
+
+	return new Title(
+		getApp()->getDisplay(),
+		textCanvas,
+		getGc(),
+		getCanvas()->getVisual(),
+		*text,
+		m,
+		title,
+		getApp()->getSettings()->getTitleFont().getColor(),
+		cs.cornerRadius,
+		cs.alpha,
+		cs.color);
+}
+
+/**
+ * Create everything drawing needs in advance so the first frame isn't
+ * slower than the following ones
+ */
+void PieMenuWindow::prepare() {
+	TransparentWindow::prepare();
+
+	if (!getApp()->getSettings()->getShowTitle()) {
+		return;
 	}
 
-	// draw cartouche
-	{
-		CartoucheMap::const_iterator i;
-		Cartouche *c;
-
-		if ((i = cartoucheMap.find(m.getWidth())) == cartoucheMap.end()) {
-			int rr = (r << 1) + r;
-
-			cartoucheMap[m.getWidth()] = c = new Cartouche(
-				m.getWidth() + rr,
-				m.getHeight() + rr,
-				r,
-				getApp()->getSettings()->getCartoucheSettings().color);
-		} else {
-			c = i->second;
-		}
+	if (!text) {
+		createText();
+	}
 
-		menu.getBlender()->blend(
-			*c,
-			((getWidth()-c->getWidth()) >> 1),
-			((getHeight()-c->getHeight()) >> 1),
-			getApp()->getSettings()->getCartoucheSettings().alpha);
+	const Settings::CartoucheSettings &cs =
+		getApp()->getSettings()->getCartoucheSettings();
+
+	Title::prepare(cs.cornerRadius, cs.alpha, cs.color);
+
+	// measuring makes Xft load the glyphs
+	for (unsigned int c = 0x20; c < 0x7f; ++c) {
+		text->getAdvance(c);
 	}
+}
 
-	// XftDrawString/XDrawString requires a Drawable (Window or Pixmap),
-	// but update() deals only with XImage, hence this detour over the
-	// textCanvas-Pixmap
-	XPutImage(
-		getApp()->getDisplay(),
-		textCanvas,
-		getGc(),
-		getCanvas()->getResource(),
-		0,
-		0,
-		0,
-		0,
-		getWidth(),
-		getHeight());
-
-	text->draw(
-		((getWidth()-m.getWidth())>>1)+m.getX(),
-		((getHeight()-m.getHeight())>>1)+m.getY(),
-		title);
-
-	XCopyArea(
-		getApp()->getDisplay(),
-		textCanvas,
-		getWindow(),
-		getGc(),
-		0,
-		0,
-		getWidth(),
-		getHeight(),
-		0,
-		0);
-
-#ifdef HAVE_XRENDER
-	if (getApp()->getSettings()->useCompositing()) {
-		XCopyArea(
+/**
+ * Add number, size and look ups of cached titles to usage
+ *
+ * @param u - usage
+ */
+void PieMenuWindow::addTitlesUsage(Statistics::Usage &u) const {
+	u.entries += titles.size();
+	u.bytes += titles.getBytes();
+	u.hits += titles.getHits();
+	u.misses += titles.getMisses();
+}
+
+/**
+ * Create text object and the Pixmap it renders into
+ */
+void PieMenuWindow::createText() {
+	// since Xft requires a Drawable, glyphs are rendered into
+	// this Pixmap and read back once per title
+	if (!(textCanvas = XCreatePixmap(
 			getApp()->getDisplay(),
-			textCanvas,
-			getAlphaPixmap(),
-			getGc(),
-			0,
-			0,
+			getWindow(),
 			getWidth(),
 			getHeight(),
-			0,
-			0);
-
-		composite();
+			getCanvas()->getResource()->depth)) || !(text = new Text(
+					getApp()->getDisplay(),
+					textCanvas,
+					getCanvas()->getVisual(),
+					Text::Font(
+						getApp()->getSettings()->getTitleFont().getFamily(),
+						getApp()->getSettings()->getTitleFont().getSize(),
+						Text::Color(0xff, 0xff, 0xff))))) {
+		throw std::runtime_error("out of memory");
 	}
-#endif
 }
 
 /**
@@ -366,14 +393,16 @@ void PieMenuWindow::updateWithText() {
  * @param placement - where to place window
  */
 void PieMenuWindow::place(PieMenuWindow::Placement placement) {
-	int screen = DefaultScreen(getApp()->getDisplay());
-	int desktopWidth = DisplayWidth(getApp()->getDisplay(), screen);
-	int desktopHeight = DisplayHeight(getApp()->getDisplay(), screen);
-	Hotspot p(getApp()->getDisplay());
+	int desktopWidth = DisplayWidth(getApp()->getDisplay(), getScreen());
+	int desktopHeight = DisplayHeight(getApp()->getDisplay(), getScreen());
+	Hotspot p(
+		getApp()->getDisplay(),
+		RootWindow(getApp()->getDisplay(), getScreen()));
 	int x = p.getX();
 	int y = p.getY();
 
 	menu.setWindowBelowCursor(p.getChild());
+	pointer.setPosition(p.getRootX(), p.getRootY());
 
 	x -= getWidth() >> 1;
 	y -= getHeight() >> 1;
@@ -395,4 +424,7 @@ void PieMenuWindow::place(PieMenuWindow::Placement placement) {
 	}
 
 	XMoveWindow(getApp()->getDisplay(), getWindow(), x, y);
+
+	windowX = x;
+	windowY = y;
 }
@@ -4,7 +4,10 @@
 #include "TransparentWindow.h"
 #include "PieMenu.h"
 #include "Text.h"
-#include "Cartouche.h"
+#include "Title.h"
+#include "LruCache.h"
+#include "Statistics.h"
+#include "PointerTracker.h"
 
 #include <time.h>
 
@@ -16,27 +19,52 @@ public:
 		IconBelowCursor
 	};
 
-	PieMenuWindow(Application &);
+	PieMenuWindow(Application &, int = -1);
 	virtual ~PieMenuWindow();
 	bool appear(std::string = "", Placement = AroundCursor);
+	inline void prewarm() {
+		menu.prewarm();
+	}
+	inline bool prewarm(const std::string &n) {
+		return menu.prewarm(n);
+	}
+	inline void forgetMenuItems() {
+		menu.forgetMenuItems();
+	}
+	inline void deselect(MenuItem *item) {
+		menu.deselect(item);
+	}
+	inline bool isAnimating() const {
+		return menu.isAnimating();
+	}
 	void draw();
 	bool processEvent(XEvent &);
+	void prepare();
+	void addTitlesUsage(Statistics::Usage &) const;
 
 protected:
-	typedef std::map<int, Cartouche *> CartoucheMap;
-
 	virtual void show(Placement = AroundCursor);
 	virtual void hide();
-	virtual void updateWithText();
+	virtual void drawTitle();
+	virtual Title *createTitle(const std::string &);
 	virtual bool performAction(Settings::Action);
 	virtual void place(Placement);
 
 private:
+	enum {
+		MaximumTitles = 64
+	};
+
 	static const std::string ShowMessage;
 	PieMenu menu;
+	PointerTracker pointer;
+	int windowX;
+	int windowY;
 	Pixmap textCanvas;
 	Text *text;
-	CartoucheMap cartoucheMap;
+	LruCache<std::string, Title> titles;
+
+	void createText();
 };
 }
 
@@ -0,0 +1,124 @@
+#include "PointerTracker.h"
+
+#ifdef HAVE_XI2
+#include <X11/extensions/XInput2.h>
+#include <string.h>
+#endif
+
+using namespace PieDock;
+
+/**
+ * Initialize pointer tracker; uses XInput2 motion events if available
+ * and falls back to core MotionNotify events otherwise
+ *
+ * @param d - display
+ * @param r - root window of the screen to track, if not given the
+ *            default root window (optional)
+ */
+PointerTracker::PointerTracker(Display *d, Window r) :
+	display(d),
+	root(r ? r : DefaultRootWindow(d)),
+	rootX(0),
+	rootY(0) {
+#ifdef HAVE_XI2
+	int event;
+	int error;
+	int major = 2;
+	int minor = 0;
+
+	xi2 = XQueryExtension(
+			display,
+			"XInputExtension",
+			&opcode,
+			&event,
+			&error) &&
+		XIQueryVersion(display, &major, &minor) == Success;
+#endif
+}
+
+/**
+ * Start tracking; the current position must be set before with
+ * setPosition() since this doesn't query the pointer
+ */
+void PointerTracker::start() {
+#ifdef HAVE_XI2
+	select(true);
+#endif
+}
+
+/**
+ * Stop tracking
+ */
+void PointerTracker::stop() {
+#ifdef HAVE_XI2
+	select(false);
+#endif
+}
+
+/**
+ * Process event; returns true if the event was a motion event, only
+ * the last position of a series of motion events is kept
+ *
+ * @param event - X event
+ */
+bool PointerTracker::processEvent(XEvent &event) {
+	switch (event.type) {
+	case MotionNotify:
+		rootX = event.xmotion.x_root;
+		rootY = event.xmotion.y_root;
+		return true;
+#ifdef HAVE_XI2
+	case GenericEvent:
+		if (!xi2 ||
+				event.xcookie.extension != opcode ||
+				!XGetEventData(display, &event.xcookie)) {
+			return false;
+		}
+
+		if (event.xcookie.evtype == XI_Motion) {
+			XIDeviceEvent *de =
+				reinterpret_cast<XIDeviceEvent *>(event.xcookie.data);
+
+			rootX = static_cast<int>(de->root_x);
+			rootY = static_cast<int>(de->root_y);
+		}
+
+		XFreeEventData(display, &event.xcookie);
+		return true;
+#endif
+	}
+
+	return false;
+}
+
+#ifdef HAVE_XI2
+/**
+ * Select or deselect XInput2 motion events on the root window
+ *
+ * @param motion - true to select motion events
+ */
+void PointerTracker::select(bool motion) {
+	if (!xi2) {
+		return;
+	}
+
+	unsigned char mask[XIMaskLen(XI_LASTEVENT)];
+	XIEventMask em;
+
+	memset(mask, 0, sizeof(mask));
+
+	if (motion) {
+		XISetMask(mask, XI_Motion);
+	}
+
+	em.deviceid = XIAllMasterDevices;
+	em.mask_len = sizeof(mask);
+	em.mask = mask;
+
+	XISelectEvents(
+		display,
+		root,
+		&em,
+		1);
+}
+#endif
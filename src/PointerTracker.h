@@ -0,0 +1,39 @@
+#ifndef _PieDock_PointerTracker_
+#define _PieDock_PointerTracker_
+
+#include <X11/Xlib.h>
+
+namespace PieDock {
+class PointerTracker {
+public:
+	PointerTracker(Display *, Window = 0);
+	virtual ~PointerTracker() {}
+	inline const int &getRootX() const {
+		return rootX;
+	}
+	inline const int &getRootY() const {
+		return rootY;
+	}
+	inline void setPosition(int x, int y) {
+		rootX = x;
+		rootY = y;
+	}
+	virtual void start();
+	virtual void stop();
+	virtual bool processEvent(XEvent &);
+
+private:
+	Display *display;
+	Window root;
+	int rootX;
+	int rootY;
+#ifdef HAVE_XI2
+	int opcode;
+	bool xi2;
+
+	void select(bool);
+#endif
+};
+}
+
+#endif
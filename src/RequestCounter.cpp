@@ -0,0 +1,122 @@
+#include "RequestCounter.h"
+
+using namespace PieDock;
+
+const char *RequestCounter::names[] = {
+	"x_other",
+	"x_update",
+	"x_draw",
+	"x_upload",
+	"x_activate"
+};
+
+RequestCounter::Phase RequestCounter::current = RequestCounter::Other;
+unsigned long RequestCounter::mark = 0;
+unsigned long RequestCounter::opens = 0;
+unsigned long RequestCounter::requests[RequestCounter::NumberOfPhases];
+unsigned long RequestCounter::roundTrips[RequestCounter::NumberOfPhases];
+unsigned long RequestCounter::openRequests[RequestCounter::NumberOfPhases];
+unsigned long RequestCounter::openRoundTrips[RequestCounter::NumberOfPhases];
+unsigned long RequestCounter::lastRequests[RequestCounter::NumberOfPhases];
+unsigned long RequestCounter::lastRoundTrips[RequestCounter::NumberOfPhases];
+
+/**
+ * Enter phase
+ *
+ * @param d - display
+ * @param p - phase
+ */
+RequestCounter::Scope::Scope(Display *d, Phase p) :
+	display(d),
+	outer(current) {
+	account(display);
+	current = p;
+}
+
+/**
+ * Leave phase
+ */
+RequestCounter::Scope::~Scope() {
+	account(display);
+	current = outer;
+}
+
+/**
+ * Remember counters when a menu is opened
+ *
+ * @param d - display
+ */
+void RequestCounter::beginOpen(Display *d) {
+	account(d);
+
+	for (int i = 0; i < NumberOfPhases; ++i) {
+		openRequests[i] = requests[i];
+		openRoundTrips[i] = roundTrips[i];
+	}
+}
+
+/**
+ * Keep counters of the menu that has just been closed
+ *
+ * @param d - display
+ */
+void RequestCounter::endOpen(Display *d) {
+	account(d);
+	++opens;
+
+	for (int i = 0; i < NumberOfPhases; ++i) {
+		lastRequests[i] = requests[i] - openRequests[i];
+		lastRoundTrips[i] = roundTrips[i] - openRoundTrips[i];
+	}
+}
+
+/**
+ * Write a line with total and last open request and round trip
+ * counts for every phase
+ *
+ * @param out - output stream
+ * @param nl - line terminator (optional)
+ */
+void RequestCounter::report(std::ostream &out, char nl) {
+	out << "x_opens " << opens << nl;
+
+	for (int i = 0; i < NumberOfPhases; ++i) {
+		out << names[i] <<
+			" requests " << requests[i] <<
+			" round_trips " << roundTrips[i] <<
+			" last_requests " << lastRequests[i] <<
+			" last_round_trips " << lastRoundTrips[i] << nl;
+	}
+}
+
+/**
+ * Drop all counts
+ */
+void RequestCounter::reset() {
+	for (int i = 0; i < NumberOfPhases; ++i) {
+		requests[i] = 0;
+		roundTrips[i] = 0;
+		openRequests[i] = 0;
+		openRoundTrips[i] = 0;
+		lastRequests[i] = 0;
+		lastRoundTrips[i] = 0;
+	}
+
+	opens = 0;
+}
+
+/**
+ * Add requests issued since the last call to the current phase
+ *
+ * @param d - display
+ */
+void RequestCounter::account(Display *d) {
+	unsigned long n = NextRequest(d);
+
+	// the first call only sets the mark
+	if (mark) {
+		requests[current] += n - mark;
+	}
+
+	mark = n;
+}
@@ -0,0 +1,67 @@
+#ifndef _PieDock_RequestCounter_
+#define _PieDock_RequestCounter_
+
+#include <X11/Xlib.h>
+
+#include <ostream>
+
+namespace PieDock {
+class RequestCounter {
+public:
+	enum Phase {
+		Other,
+		Update,
+		Draw,
+		Upload,
+		Activate,
+		NumberOfPhases
+	};
+
+	/**
+	 * Attribute X requests to a phase while in scope; scopes may
+	 * be nested, requests always count for the innermost one
+	 */
+	class Scope {
+	public:
+		Scope(Display *, Phase);
+		virtual ~Scope();
+
+	private:
+		Display *display;
+		Phase outer;
+	};
+
+	static inline const char *getName(Phase p) {
+		return names[p];
+	}
+	static inline const unsigned long &getLastRequests(Phase p) {
+		return lastRequests[p];
+	}
+	static inline const unsigned long &getLastRoundTrips(Phase p) {
+		return lastRoundTrips[p];
+	}
+	static inline void roundTrip() {
+		++roundTrips[current];
+	}
+	static void beginOpen(Display *);
+	static void endOpen(Display *);
+	static void report(std::ostream &, char = '\n');
+	static void reset();
+
+private:
+	static const char *names[];
+	static Phase current;
+	static unsigned long mark;
+	static unsigned long opens;
+	static unsigned long requests[];
+	static unsigned long roundTrips[];
+	static unsigned long openRequests[];
+	static unsigned long openRoundTrips[];
+	static unsigned long lastRequests[];
+	static unsigned long lastRoundTrips[];
+
+	static void account(Display *);
+};
+}
+
+#endif
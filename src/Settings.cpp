@@ -1,7 +1,9 @@
 #include "Settings.h"
 #include "ModMask.h"
 #include "Environment.h"
+#include "CacheFile.h"
 
+#include <sys/stat.h>
 #include <dirent.h>
 #include <stdlib.h>
 #include <string.h>
@@ -22,41 +24,181 @@ void Settings::setConfigurationFileFromBinary(std::string b) {
 }
 
 /**
- * Returns the mouse button functions for the given menu and icon
+ * Returns the action of a mouse button for the given menu and icon or
+ * NoAction if there is none
  *
  * @param menu - currently active menu name
  * @param item - currently selected item
+ * @param button - button number
  */
-Settings::ButtonFunctions Settings::getButtonFunctions(
+Settings::Action Settings::getButtonAction(
 	const std::string &menu,
-	MenuItem *item) {
-	// normally, the first matching button function will be used,
-	// so start with defnitions that will override the others.
-	ButtonFunctions functions;
-
-	// first, append item functions
-	if (itemButtonFunctions.find(item) != itemButtonFunctions.end()) {
-		functions.insert(
-			functions.end(),
-			itemButtonFunctions.find(item)->second.begin(),
-			itemButtonFunctions.find(item)->second.end());
+	MenuItem *item,
+	unsigned int button) const {
+	const ButtonToAction *bta = &buttonActions;
+
+	// item tables include menu and default functions,
+	// menu tables include default functions
+	{
+		ItemToButtonActions::const_iterator i;
+		MenuToButtonActions::const_iterator m;
+
+		if (item &&
+				(i = itemButtonActions.find(item)) !=
+					itemButtonActions.end()) {
+			bta = &(*i).second;
+		} else if ((m = menuButtonActions.find(menu)) !=
+				menuButtonActions.end()) {
+			bta = &(*m).second;
+		}
+	}
+
+	ButtonToAction::const_iterator i;
+
+	if ((i = bta->find(button)) == bta->end()) {
+		return NoAction;
+	}
+
+	return (*i).second;
+}
+
+/**
+ * Resolve key symbols to key codes and build the tables used to
+ * dispatch events; needs to be called again when the keyboard mapping
+ * changes
+ *
+ * @param d - display
+ */
+void Settings::updateDispatchTables(Display *d) {
+	// root triggers; the first matching trigger wins
+	for (int n = 0x100; n--;) {
+		keyTriggers[n].clear();
+		buttonTriggers[n].clear();
+	}
+
+	for (Keys::iterator i = keys.begin();
+			i != keys.end();
+			++i) {
+		TriggerTable *t = &keyTriggers[
+			((*i).keyCode = XKeysymToKeycode(d, (*i).keySym))];
+
+		if (t->empty()) {
+			t->resize(0x100, 0);
+		}
+
+		for (unsigned int state = 0; state < 0x100; ++state) {
+			// AnyModifier (32768 in X.h) cannot be used
+			// for binary operations
+			if (!(*t)[state] &&
+					((*i).modifier == AnyModifier ||
+						((*i).modifier & state))) {
+				(*t)[state] = &(*i);
+			}
+		}
+	}
+
+	for (Buttons::iterator i = buttons.begin();
+			i != buttons.end();
+			++i) {
+		TriggerTable *t = &buttonTriggers[(*i).button & 0xff];
+
+		if (t->empty()) {
+			t->resize(0x200, 0);
+		}
+
+		// on some implementations of X, for example
+		// X.Org X 1.6.3.901 (1.6.4 RC1) 64bit, we receive
+		// ButtonPress events even when XGrabButton had only
+		// ButtonReleaseMask selected which causes all
+		// menus to appear on a button press; hence the
+		// separate tables for press and release
+		unsigned int offset = (*i).eventMask == ButtonReleaseMask ?
+			0x100 :
+			0;
+
+		for (unsigned int state = 0; state < 0x100; ++state) {
+			if (!(*t)[offset | state] &&
+					((*i).modifier == AnyModifier ||
+						((*i).modifier & state))) {
+				(*t)[offset | state] = &(*i);
+			}
+		}
+	}
+
+	// key functions within the menu
+	for (int n = 0x100; n--;) {
+		keyActions[n][0] = keyActions[n][1] = NoAction;
+	}
+
+	for (KeyFunctions::iterator i = keyFunctions.begin();
+			i != keyFunctions.end();
+			++i) {
+		Action *a = &keyActions[XKeysymToKeycode(d, (*i).keySym)][
+			(*i).eventType == KeyRelease ? 1 : 0];
+
+		if (*a == NoAction) {
+			*a = (*i).action;
+		}
+	}
+
+	// button functions; item functions override menu functions
+	// which override default functions
+	buttonActions.clear();
+	menuButtonActions.clear();
+	itemButtonActions.clear();
+
+	for (ButtonFunctions::iterator i = buttonFunctions.begin();
+			i != buttonFunctions.end();
+			++i) {
+		buttonActions.insert(std::make_pair((*i).button, (*i).action));
 	}
 
-	// menu functions
-	if (menuButtonFunctions.find(menu) != menuButtonFunctions.end()) {
-		functions.insert(
-			functions.end(),
-			menuButtonFunctions.find(menu)->second.begin(),
-			menuButtonFunctions.find(menu)->second.end());
+	for (std::map<std::string, ButtonFunctions>::iterator m =
+				menuButtonFunctions.begin();
+			m != menuButtonFunctions.end();
+			++m) {
+		ButtonToAction *bta = &menuButtonActions[(*m).first];
+
+		for (ButtonFunctions::iterator i = (*m).second.begin();
+				i != (*m).second.end();
+				++i) {
+			bta->insert(std::make_pair((*i).button, (*i).action));
+		}
+
+		bta->insert(buttonActions.begin(), buttonActions.end());
 	}
 
-	// default functions
-	functions.insert(
-		functions.end(),
-		buttonFunctions.begin(),
-		buttonFunctions.end());
+	for (Menus::iterator m = menus.begin();
+			m != menus.end();
+			++m) {
+		MenuToButtonActions::iterator mba =
+			menuButtonActions.find((*m).first);
+
+		for (MenuItems::iterator i = (*m).second.begin();
+				i != (*m).second.end();
+				++i) {
+			std::map<MenuItem *, ButtonFunctions>::iterator ibf;
+
+			if ((ibf = itemButtonFunctions.find(*i)) ==
+					itemButtonFunctions.end()) {
+				continue;
+			}
+
+			ButtonToAction *bta = &itemButtonActions[*i];
+
+			for (ButtonFunctions::iterator f = (*ibf).second.begin();
+					f != (*ibf).second.end();
+					++f) {
+				bta->insert(std::make_pair((*f).button, (*f).action));
+			}
 
-	return functions;
+			if (mba != menuButtonActions.end()) {
+				bta->insert((*mba).second.begin(), (*mba).second.end());
+			} else {
+				bta->insert(buttonActions.begin(), buttonActions.end());
+			}
+		}
+	}
 }
 
 /**
@@ -65,59 +207,62 @@ Settings::ButtonFunctions Settings::getButtonFunctions(
  * @param d - display to load settings for
  */
 void Settings::load(Display *d) {
-	std::ifstream in(configurationFile.c_str(), std::ios::in);
+	read(d);
+	preloadIcons();
+}
 
-	if (!in || !in.good()) {
-		throw std::ios_base::failure("cannot read configuration file");
-	}
+/**
+ * Parse configuration file; icons are loaded when they are needed or
+ * by preloadIcons()
+ *
+ * @param d - display to load settings for
+ */
+void Settings::read(Display *d) {
+	std::string text;
+	struct stat buf;
 
-	// reset settings to default values
+	// read the whole file at once since its contents are needed
+	// for the cache key anyway
 	{
-		width = height = 320;
-		keys.clear();
-		buttons.clear();
-		buttonFunctions.clear();
-		menuButtonFunctions.clear();
-		itemButtonFunctions.clear();
-		keyFunctions.clear();
-		iconMap.reset();
-		clearMenus();
-		activeIndicator.reset();
-		focusedAlpha = unfocusedAlpha = 0xff;
-		startRadius = .9;
-		fitts = true;
-		zoomModifier = 1.0;
-		spinStep = .5;
-		centerAction = CenterDisappear;
-		showTitle = false;
-		titleFont.reset();
-		cartoucheSettings.cornerRadius = 4;
-		cartoucheSettings.alpha = 196;
-		cartoucheSettings.color = 0xff000000;
-		minimumNumber = 0;
-		workspaceDisplaySettings.visible = true;
-		workspaceDisplaySettings.preferredLayout = WorkspaceLayout::Square;
-		workspaceDisplaySettings.workspaceColor = 0xc4000000;
-		workspaceDisplaySettings.windowColor = 0xbfffffff;
-#ifdef HAVE_XRENDER
-		compositing = false;
-#endif
+		std::ifstream in(configurationFile.c_str(), std::ios::in);
+
+		if (!in || !in.good() ||
+				stat(configurationFile.c_str(), &buf) < 0) {
+			throw std::ios_base::failure("cannot read configuration file");
+		}
+
+		std::ostringstream contents;
+		contents << in.rdbuf();
+		text = contents.str();
 	}
 
-	// initialize temporary memorizers
-	typedef std::vector<unsigned int> MasksToIgnore;
+	// mod mask
+	ModMask modMask(d);
 
-	enum PreloadSetting {
-		PreloadNone = 0,
-		PreloadAll,
-		PreloadMenus
-	};
+	// modifiers are resolved while parsing, so the cache is only
+	// valid for the same file and the same modifier mapping
+	CacheFile key;
 
-	PreloadSetting preload = PreloadNone;
+	key.putInt(CacheVersion);
+	key.putInt(buf.st_size);
+	key.putInt(buf.st_mtime);
+	key.putInt(CacheFile::hash(text.data(), text.size()));
+	key.putInt(modMask.getHash());
+	key.putString(Environment::getHome());
+
+	reset();
+
+	if (restore(key.getData())) {
+		updateDispatchTables(d);
+		return;
+	}
+
+	std::istringstream in(text);
+
+	// initialize temporary memorizers
+	typedef std::vector<unsigned int> MasksToIgnore;
 
-	// mod mask
 	MasksToIgnore masksToIgnore;
-	ModMask modMask(d);
 
 	// parse file
 	Statement statement;
@@ -182,7 +327,7 @@ void Settings::load(Display *d) {
 			} else {
 				std::string type = (*++i);
 				struct Trigger trigger = {
-					AnyModifier, 0, "", 0
+					AnyModifier, 0, "", 0, 0
 				};
 
 				// substract directive and first argument
@@ -472,6 +617,24 @@ void Settings::load(Display *d) {
 			} else {
 				fitts = static_cast<bool>(atoi((*++i).c_str()));
 			}
+		} else if (!(*i).compare("prewarm")) {
+			if (tokens.size() != 2) {
+				throwParsingError(
+					"insufficient arguments for prewarm directive",
+					line);
+			} else {
+				prewarm = static_cast<bool>(atoi((*++i).c_str()));
+			}
+		} else if (!(*i).compare("fps")) {
+			if (tokens.size() != 2) {
+				throwParsingError(
+					"insufficient arguments for fps directive",
+					line);
+			} else if ((fps = atoi((*++i).c_str())) < 1) {
+				throwParsingError(
+					"fps must be greater than zero",
+					line);
+			}
 		} else if (!(*i).compare("zoom")) {
 			if (tokens.size() != 2) {
 				throwParsingError(
@@ -616,7 +779,8 @@ void Settings::load(Display *d) {
 						(*ki).modifier | (*mi),
 						(*ki).keySym,
 						(*ki).menuName,
-						(*ki).eventMask
+						(*ki).eventMask,
+						0
 					};
 
 					keysToAdd.push_back(trigger);
@@ -643,7 +807,8 @@ void Settings::load(Display *d) {
 						(*bi).modifier | (*mi),
 						(*bi).button,
 						(*bi).menuName,
-						(*bi).eventMask
+						(*bi).eventMask,
+						0
 					};
 
 					buttonsToAdd.push_back(trigger);
@@ -658,8 +823,438 @@ void Settings::load(Display *d) {
 		}
 	}
 
-	// this should be done after parsing the whole file to ensure
-	// all alias- and path-directives are processed
+	// a cache that can't be written just means parsing again
+	// next time
+	store(key.getData());
+
+	updateDispatchTables(d);
+}
+
+/**
+ * Reset settings to default values and free all menus and icons
+ */
+void Settings::reset() {
+	width = height = 320;
+	keys.clear();
+	buttons.clear();
+	buttonFunctions.clear();
+	menuButtonFunctions.clear();
+	itemButtonFunctions.clear();
+	keyFunctions.clear();
+	iconMap.reset();
+	workspaceIconMap.clear();
+	clearMenus();
+	windowsToIgnore.clear();
+	preload = PreloadNone;
+	activeIndicator.reset();
+	focusedAlpha = unfocusedAlpha = 0xff;
+	startRadius = .9;
+	fitts = true;
+	prewarm = false;
+	fps = 100;
+	zoomModifier = 1.0;
+	spinStep = .5;
+	centerAction = CenterDisappear;
+	showTitle = false;
+	titleFont.reset();
+	cartoucheSettings.cornerRadius = 4;
+	cartoucheSettings.alpha = 196;
+	cartoucheSettings.color = 0xff000000;
+	minimumNumber = 0;
+	workspaceDisplaySettings.visible = true;
+	workspaceDisplaySettings.preferredLayout = WorkspaceLayout::Square;
+	workspaceDisplaySettings.workspaceColor = 0xc4000000;
+	workspaceDisplaySettings.windowColor = 0xbfffffff;
+#ifdef HAVE_XRENDER
+	compositing = false;
+#endif
+}
+
+/**
+ * Write parsed settings to cache file
+ *
+ * @param key - cache key
+ */
+void Settings::store(const std::string &key) const {
+	CacheFile f;
+
+	f.putString(key);
+	f.putInt(width);
+	f.putInt(height);
+	storeTriggers(f, keys, true);
+	storeTriggers(f, buttons, false);
+	storeButtonFunctions(f, buttonFunctions);
+
+	f.putInt(keyFunctions.size());
+	for (KeyFunctions::const_iterator i = keyFunctions.begin();
+			i != keyFunctions.end();
+			++i) {
+		f.putInt((*i).keySym);
+		f.putInt((*i).action);
+		f.putInt((*i).eventType);
+	}
+
+	// icon look up
+	{
+		const IconMap::Paths &paths = iconMap.getPath();
+
+		f.putInt(paths.size());
+		for (IconMap::Paths::const_iterator i = paths.begin();
+				i != paths.end();
+				++i) {
+			f.putString(*i);
+		}
+
+		storeAliases(f, iconMap.getNameAliases());
+		storeAliases(f, iconMap.getClassAliases());
+		storeAliases(f, iconMap.getTitleAliases());
+		f.putString(iconMap.getFileForMissing());
+		f.putString(iconMap.getFileForFiller());
+	}
+
+	f.putInt(menus.size());
+	for (Menus::const_iterator m = menus.begin();
+			m != menus.end();
+			++m) {
+		f.putString((*m).first);
+		f.putInt(
+			(*m).second.includeWindows() |
+			(*m).second.oneIconPerWindow() << 1 |
+			(*m).second.onlyFromActive() << 2);
+		f.putInt((*m).second.size());
+
+		for (MenuItems::const_iterator i = (*m).second.begin();
+				i != (*m).second.end();
+				++i) {
+			std::map<MenuItem *, ButtonFunctions>::const_iterator b =
+				itemButtonFunctions.find(*i);
+
+			f.putString((*i)->getTitle());
+			f.putString((*i)->getCommand());
+			storeButtonFunctions(
+				f,
+				b != itemButtonFunctions.end() ?
+					(*b).second :
+					ButtonFunctions());
+		}
+	}
+
+	f.putInt(menuButtonFunctions.size());
+	for (std::map<std::string, ButtonFunctions>::const_iterator i =
+				menuButtonFunctions.begin();
+			i != menuButtonFunctions.end();
+			++i) {
+		f.putString((*i).first);
+		storeButtonFunctions(f, (*i).second);
+	}
+
+	f.putInt(windowsToIgnore.size());
+	for (WindowsToIgnore::const_iterator i = windowsToIgnore.begin();
+			i != windowsToIgnore.end();
+			++i) {
+		f.putString((*i).first);
+	}
+
+	f.putInt(preload);
+	f.putString(activeIndicator.getFile());
+	f.putInt(activeIndicator.getAlignment());
+	f.putInt(focusedAlpha);
+	f.putInt(unfocusedAlpha);
+	f.putDouble(startRadius);
+	f.putInt(fitts);
+	f.putInt(prewarm);
+	f.putInt(fps);
+	f.putDouble(zoomModifier);
+	f.putDouble(spinStep);
+	f.putInt(centerAction);
+	f.putInt(showTitle);
+	f.putString(titleFont.getFamily());
+	f.putDouble(titleFont.getSize());
+	f.putInt(titleFont.getColor().getColor());
+	f.putInt(cartoucheSettings.cornerRadius);
+	f.putInt(cartoucheSettings.alpha);
+	f.putInt(cartoucheSettings.color);
+	f.putInt(minimumNumber);
+	f.putInt(workspaceDisplaySettings.visible);
+	f.putInt(workspaceDisplaySettings.preferredLayout);
+	f.putInt(workspaceDisplaySettings.workspaceColor);
+	f.putInt(workspaceDisplaySettings.windowColor);
+#ifdef HAVE_XRENDER
+	f.putInt(compositing);
+#else
+	f.putInt(0);
+#endif
+
+	f.write(getCacheFile());
+}
+
+/**
+ * Read settings from cache file; returns false if there is no valid
+ * cache for the given key and the settings are left at default values
+ *
+ * @param key - cache key
+ */
+bool Settings::restore(const std::string &key) {
+	CacheFile f;
+
+	if (!f.read(getCacheFile())) {
+		return false;
+	}
+
+	try {
+		if (f.getString() != key) {
+			return false;
+		}
+
+		width = f.getInt();
+		height = f.getInt();
+		restoreTriggers(f, keys, true);
+		restoreTriggers(f, buttons, false);
+		restoreButtonFunctions(f, buttonFunctions);
+
+		for (int n = f.getInt(); n-- > 0;) {
+			KeyFunction kf;
+
+			kf.keySym = f.getInt();
+			kf.action = static_cast<Action>(f.getInt());
+			kf.eventType = f.getInt();
+			keyFunctions.push_back(kf);
+		}
+
+		// icon look up
+		{
+			for (int n = f.getInt(); n-- > 0;) {
+				iconMap.addPath(f.getString());
+			}
+
+			for (int n = f.getInt(); n-- > 0;) {
+				std::string a = f.getString();
+				iconMap.addNameAlias(a, f.getString());
+			}
+
+			for (int n = f.getInt(); n-- > 0;) {
+				std::string a = f.getString();
+				iconMap.addClassAlias(a, f.getString());
+			}
+
+			for (int n = f.getInt(); n-- > 0;) {
+				std::string a = f.getString();
+				iconMap.addTitleAlias(a, f.getString());
+			}
+
+			iconMap.setFileForMissing(f.getString());
+			iconMap.setFileForFiller(f.getString());
+		}
+
+		for (int n = f.getInt(); n-- > 0;) {
+			MenuItems &items = menus[f.getString()];
+			int flags = f.getInt();
+
+			items.setIncludeWindows(flags & 1);
+			items.setOneIconPerWindow(flags & 2);
+			items.setOnlyFromActive(flags & 4);
+
+			for (int i = f.getInt(); i-- > 0;) {
+				std::string title = f.getString();
+				MenuItem *item = new MenuItem(title, f.getString());
+				ButtonFunctions bfs;
+
+				items.push_back(item);
+				restoreButtonFunctions(f, bfs);
+
+				if (!bfs.empty()) {
+					itemButtonFunctions[item] = bfs;
+				}
+			}
+		}
+
+		for (int n = f.getInt(); n-- > 0;) {
+			restoreButtonFunctions(f, menuButtonFunctions[f.getString()]);
+		}
+
+		for (int n = f.getInt(); n-- > 0;) {
+			windowsToIgnore[f.getString()] = true;
+		}
+
+		preload = static_cast<PreloadSetting>(f.getInt());
+
+		{
+			std::string file = f.getString();
+			int alignment = f.getInt();
+
+			if (!file.empty()) {
+				activeIndicator.load(file);
+			}
+
+			activeIndicator.setAlignment(alignment);
+		}
+
+		focusedAlpha = f.getInt();
+		unfocusedAlpha = f.getInt();
+		startRadius = f.getDouble();
+		fitts = f.getInt();
+		prewarm = f.getInt();
+		fps = f.getInt();
+		zoomModifier = f.getDouble();
+		spinStep = f.getDouble();
+		centerAction = static_cast<CenterAction>(f.getInt());
+		showTitle = f.getInt();
+		titleFont.setFamily(f.getString());
+		titleFont.setSize(f.getDouble());
+
+		{
+			unsigned int c = f.getInt();
+
+			titleFont.setColor(Text::Color(
+				c >> 16 & 0xff,
+				c >> 8 & 0xff,
+				c & 0xff,
+				c >> 24 & 0xff));
+		}
+
+		cartoucheSettings.cornerRadius = f.getInt();
+		cartoucheSettings.alpha = f.getInt();
+		cartoucheSettings.color = f.getInt();
+		minimumNumber = f.getInt();
+		workspaceDisplaySettings.visible = f.getInt();
+		workspaceDisplaySettings.preferredLayout =
+			static_cast<WorkspaceLayout::PreferredVirtualLayout>(
+				f.getInt());
+		workspaceDisplaySettings.workspaceColor = f.getInt();
+		workspaceDisplaySettings.windowColor = f.getInt();
+#ifdef HAVE_XRENDER
+		compositing = f.getInt();
+#else
+		f.getInt();
+#endif
+
+		if (!f.atEnd()) {
+			throw std::runtime_error("corrupt cache file");
+		}
+	} catch (std::exception &) {
+		// fall back to parsing
+		reset();
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Write triggers to cache file
+ *
+ * @param f - cache file
+ * @param triggers - triggers
+ * @param keySyms - true for key triggers, false for button triggers
+ */
+void Settings::storeTriggers(
+	CacheFile &f,
+	const Keys &triggers,
+	bool keySyms) {
+	f.putInt(triggers.size());
+
+	for (Keys::const_iterator i = triggers.begin();
+			i != triggers.end();
+			++i) {
+		f.putInt((*i).modifier);
+		f.putInt(keySyms ? (*i).keySym : (*i).button);
+		f.putString((*i).menuName);
+		f.putInt((*i).eventMask);
+	}
+}
+
+/**
+ * Read triggers from cache file
+ *
+ * @param f - cache file
+ * @param triggers - triggers
+ * @param keySyms - true for key triggers, false for button triggers
+ */
+void Settings::restoreTriggers(
+	CacheFile &f,
+	Keys &triggers,
+	bool keySyms) {
+	for (int n = f.getInt(); n-- > 0;) {
+		Trigger trigger = {
+			AnyModifier, 0, "", 0, 0
+		};
+
+		trigger.modifier = f.getInt();
+
+		if (keySyms) {
+			trigger.keySym = f.getInt();
+		} else {
+			trigger.button = f.getInt();
+		}
+
+		trigger.menuName = f.getString();
+		trigger.eventMask = f.getInt();
+		triggers.push_back(trigger);
+	}
+}
+
+/**
+ * Write button functions to cache file
+ *
+ * @param f - cache file
+ * @param bfs - button functions
+ */
+void Settings::storeButtonFunctions(
+	CacheFile &f,
+	const ButtonFunctions &bfs) {
+	f.putInt(bfs.size());
+
+	for (ButtonFunctions::const_iterator i = bfs.begin();
+			i != bfs.end();
+			++i) {
+		f.putInt((*i).button);
+		f.putInt((*i).action);
+	}
+}
+
+/**
+ * Read button functions from cache file
+ *
+ * @param f - cache file
+ * @param bfs - button functions
+ */
+void Settings::restoreButtonFunctions(
+	CacheFile &f,
+	ButtonFunctions &bfs) {
+	for (int n = f.getInt(); n-- > 0;) {
+		ButtonFunction bf;
+
+		bf.button = f.getInt();
+		bf.action = static_cast<Action>(f.getInt());
+		bfs.push_back(bf);
+	}
+}
+
+/**
+ * Write icon aliases to cache file
+ *
+ * @param f - cache file
+ * @param aliases - aliases
+ */
+void Settings::storeAliases(
+	CacheFile &f,
+	const IconMap::AliasToFile &aliases) {
+	f.putInt(aliases.size());
+
+	for (IconMap::AliasToFile::const_iterator i = aliases.begin();
+			i != aliases.end();
+			++i) {
+		f.putString((*i).first);
+		f.putString((*i).second);
+	}
+}
+
+/**
+ * Load and resize icons as requested by the preload directive; this
+ * must be done after parsing the whole file to ensure all alias- and
+ * path-directives are processed
+ */
+void Settings::preloadIcons() {
 	if (preload != PreloadNone) {
 		// those values are guesses for a pie menu; if that
 		// application is supporting more menu forms some day,
@@ -739,6 +1334,134 @@ void Settings::load(Display *d) {
 	}
 }
 
+/**
+ * Return a bit mask of Changes telling what differs from some other
+ * settings object
+ *
+ * @param other - other settings
+ */
+unsigned int Settings::compare(const Settings &other) const {
+	unsigned int changes = NoChanges;
+
+	if (width != other.width ||
+			height != other.height ||
+#ifdef HAVE_XRENDER
+			compositing != other.compositing ||
+#endif
+			titleFont.getFamily() != other.titleFont.getFamily() ||
+			titleFont.getSize() != other.titleFont.getSize() ||
+			titleFont.getColor().getColor() !=
+				other.titleFont.getColor().getColor() ||
+			cartoucheSettings.cornerRadius !=
+				other.cartoucheSettings.cornerRadius ||
+			cartoucheSettings.alpha != other.cartoucheSettings.alpha ||
+			cartoucheSettings.color != other.cartoucheSettings.color) {
+		changes |= WindowChanges;
+	}
+
+	if (!iconMap.isEquivalent(other.iconMap)) {
+		changes |= IconChanges;
+	}
+
+	// only compare what comes from the configuration file,
+	// items for windows are added at run time
+	if (menus.size() != other.menus.size()) {
+		changes |= MenuChanges;
+	} else {
+		for (Menus::const_iterator m = menus.begin(), o = other.menus.begin();
+				m != menus.end();
+				++m, ++o) {
+			if ((*m).first != (*o).first ||
+					!isEquivalent((*m).second, (*o).second)) {
+				changes |= MenuChanges;
+				break;
+			}
+		}
+	}
+
+	if (!isEquivalent(keys, other.keys, true) ||
+			!isEquivalent(buttons, other.buttons, false)) {
+		changes |= TriggerChanges;
+	}
+
+	return changes;
+}
+
+/**
+ * Take over decoded and resized icons from some other settings object;
+ * must only be called if compare() reports no IconChanges
+ *
+ * @param other - other settings, loses its icons
+ */
+void Settings::adoptIcons(Settings &other) {
+	iconMap.adopt(other.iconMap);
+	workspaceIconMap.adopt(other.workspaceIconMap);
+}
+
+/**
+ * Returns true if two menus contain the same configured items
+ *
+ * @param a - some menu
+ * @param b - another menu
+ */
+bool Settings::isEquivalent(const MenuItems &a, const MenuItems &b) {
+	if (a.includeWindows() != b.includeWindows() ||
+			a.oneIconPerWindow() != b.oneIconPerWindow() ||
+			a.onlyFromActive() != b.onlyFromActive()) {
+		return false;
+	}
+
+	MenuItems::const_iterator i = a.begin();
+	MenuItems::const_iterator j = b.begin();
+
+	for (;; ++i, ++j) {
+		while (i != a.end() && !(*i)->isSticky()) {
+			++i;
+		}
+
+		while (j != b.end() && !(*j)->isSticky()) {
+			++j;
+		}
+
+		if (i == a.end() || j == b.end()) {
+			return i == a.end() && j == b.end();
+		}
+
+		if ((*i)->getTitle() != (*j)->getTitle() ||
+				(*i)->getCommand() != (*j)->getCommand()) {
+			return false;
+		}
+	}
+}
+
+/**
+ * Returns true if two trigger lists are the same
+ *
+ * @param a - some triggers
+ * @param b - other triggers
+ * @param keySyms - true for key triggers, false for button triggers
+ */
+bool Settings::isEquivalent(const Keys &a, const Keys &b, bool keySyms) {
+	if (a.size() != b.size()) {
+		return false;
+	}
+
+	for (Keys::const_iterator i = a.begin(), j = b.begin();
+			i != a.end();
+			++i, ++j) {
+		if ((*i).modifier != (*j).modifier ||
+				(keySyms ?
+					(*i).keySym != (*j).keySym :
+					(*i).button != (*j).button) ||
+				(*i).menuName != (*j).menuName ||
+				(*i).eventMask != (*j).eventMask) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 /**
  * Read a menu structure
  *
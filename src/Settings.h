@@ -3,9 +3,11 @@
 
 #include "MenuItems.h"
 #include "IconMap.h"
+#include "WorkspaceIconMap.h"
 #include "ActiveIndicator.h"
 #include "Text.h"
 #include "WorkspaceLayout.h"
+#include "CacheFile.h"
 
 #include <X11/Xlib.h>
 #include <vector>
@@ -31,6 +33,14 @@ public:
 		Disappear
 	};
 
+	enum Changes {
+		NoChanges = 0,
+		WindowChanges = 1,
+		IconChanges = 2,
+		MenuChanges = 4,
+		TriggerChanges = 8
+	};
+
 	enum CenterAction {
 		CenterIgnore,
 		CenterNearestIcon,
@@ -45,6 +55,7 @@ public:
 		};
 		std::string menuName;
 		unsigned int eventMask;
+		KeyCode keyCode;
 	} Key, Button;
 
 	typedef struct {
@@ -78,7 +89,9 @@ public:
 	typedef std::map<std::string, MenuItems> Menus;
 	typedef std::map<std::string, bool> WindowsToIgnore;
 
-	Settings() {}
+	Settings() {
+		reset();
+	}
 	virtual ~Settings() {
 		clearMenus();
 	}
@@ -88,6 +101,9 @@ public:
 	inline void setConfigurationFile(std::string s) {
 		configurationFile = s;
 	}
+	inline std::string getCacheFile() const {
+		return configurationFile + "-cache";
+	}
 	inline const int &getWidth() const {
 		return width;
 	}
@@ -111,6 +127,12 @@ public:
 	inline IconMap &getIconMap() {
 		return iconMap;
 	}
+	inline WorkspaceIconMap &getWorkspaceIconMap() {
+		return workspaceIconMap;
+	}
+	inline Menus &getMenus() {
+		return menus;
+	}
 	inline MenuItems *getMenu(std::string s) {
 		Menus::iterator i = menus.find(s);
 		if (i == menus.end()) {
@@ -136,6 +158,12 @@ public:
 	inline const bool &isFitts() const {
 		return fitts;
 	}
+	inline const bool &isPrewarm() const {
+		return prewarm;
+	}
+	inline const int &getFps() const {
+		return fps;
+	}
 	inline const double &getZoomModifier() const {
 		return zoomModifier;
 	}
@@ -161,11 +189,55 @@ public:
 	&getWorkspaceDisplaySettings() const {
 		return workspaceDisplaySettings;
 	}
+	/**
+	 * Return root trigger for a key press or 0
+	 *
+	 * @param keyCode - key code
+	 * @param state - modifier state
+	 */
+	inline const Key *getKeyTrigger(
+		unsigned int keyCode,
+		unsigned int state) const {
+		const TriggerTable &t = keyTriggers[keyCode & 0xff];
+		return t.empty() ? 0 : t[state & 0xff];
+	}
+
+	/**
+	 * Return root trigger for a button event or 0
+	 *
+	 * @param button - button number
+	 * @param type - ButtonPress or ButtonRelease
+	 * @param state - modifier state
+	 */
+	inline const Button *getButtonTrigger(
+		unsigned int button,
+		int type,
+		unsigned int state) const {
+		const TriggerTable &t = buttonTriggers[button & 0xff];
+		return t.empty() ? 0 :
+			t[(type == ButtonRelease ? 0x100 : 0) | (state & 0xff)];
+	}
+
+	/**
+	 * Return action for a key event within the menu
+	 *
+	 * @param keyCode - key code
+	 * @param type - KeyPress or KeyRelease
+	 */
+	inline Action getKeyAction(unsigned int keyCode, int type) const {
+		return keyActions[keyCode & 0xff][type == KeyRelease ? 1 : 0];
+	}
+
 	virtual void setConfigurationFileFromBinary(std::string);
-	virtual ButtonFunctions getButtonFunctions(
-		const std::string &menu = std::string(),
-		MenuItem *item = 0);
+	virtual Action getButtonAction(const std::string &,
+		MenuItem *, unsigned int) const;
+	virtual void updateDispatchTables(Display *);
 	virtual void load(Display *d);
+	virtual void read(Display *d);
+	virtual void preloadIcons();
+	virtual unsigned int compare(const Settings &) const;
+	virtual void adoptIcons(Settings &);
+	virtual void reset();
 
 protected:
 	virtual int readMenu(std::istream &, int, std::string);
@@ -174,8 +246,22 @@ protected:
 	virtual unsigned int resolveButtonCode(const std::string &) const;
 	virtual void throwParsingError(const char *, unsigned int) const;
 	virtual void presizeIcon(Icon *, int, int, int, int, int, int);
+	virtual void store(const std::string &) const;
+	virtual bool restore(const std::string &);
+	static bool isEquivalent(const MenuItems &, const MenuItems &);
+	static bool isEquivalent(const Keys &, const Keys &, bool);
 
 private:
+	enum {
+		CacheVersion = 1
+	};
+
+	enum PreloadSetting {
+		PreloadNone = 0,
+		PreloadAll,
+		PreloadMenus
+	};
+
 	/**
 	 * A statement string
 	 */
@@ -194,6 +280,17 @@ private:
 		std::string trim(std::string, const char * = " \t\r\n\"");
 	};
 
+	static void storeTriggers(CacheFile &, const Keys &, bool);
+	static void restoreTriggers(CacheFile &, Keys &, bool);
+	static void storeButtonFunctions(CacheFile &, const ButtonFunctions &);
+	static void restoreButtonFunctions(CacheFile &, ButtonFunctions &);
+	static void storeAliases(CacheFile &, const IconMap::AliasToFile &);
+
+	typedef std::vector<const Trigger *> TriggerTable;
+	typedef std::map<unsigned int, Action> ButtonToAction;
+	typedef std::map<std::string, ButtonToAction> MenuToButtonActions;
+	typedef std::map<MenuItem *, ButtonToAction> ItemToButtonActions;
+
 	std::string configurationFile;
 	int width;
 	int height;
@@ -203,14 +300,24 @@ private:
 	std::map<MenuItem *, ButtonFunctions> itemButtonFunctions;
 	std::map<std::string, ButtonFunctions> menuButtonFunctions;
 	KeyFunctions keyFunctions;
+	TriggerTable keyTriggers[0x100];
+	TriggerTable buttonTriggers[0x100];
+	Action keyActions[0x100][2];
+	ButtonToAction buttonActions;
+	MenuToButtonActions menuButtonActions;
+	ItemToButtonActions itemButtonActions;
 	IconMap iconMap;
+	WorkspaceIconMap workspaceIconMap;
 	Menus menus;
 	WindowsToIgnore windowsToIgnore;
+	PreloadSetting preload;
 	ActiveIndicator activeIndicator;
 	int focusedAlpha;
 	int unfocusedAlpha;
 	double startRadius;
 	bool fitts;
+	bool prewarm;
+	int fps;
 	double zoomModifier;
 	CenterAction centerAction;
 	double spinStep;
@@ -0,0 +1,92 @@
+#include "Statistics.h"
+
+#include <unistd.h>
+#include <stdio.h>
+
+using namespace PieDock;
+
+/**
+ * Add usage of some cache
+ *
+ * @param name - name of cache
+ * @param u - usage
+ */
+void Statistics::add(const std::string &name, const Usage &u) {
+	caches.push_back(std::make_pair(name, u));
+}
+
+/**
+ * Write all metrics in Prometheus' text exposition format
+ *
+ * @param out - output stream
+ * @param nl - line terminator (optional)
+ */
+void Statistics::write(std::ostream &out, char nl) const {
+	writeMetric(out, "piedock_cache_entries", "gauge",
+		"Number of entries in cache", &Usage::entries, nl);
+	writeMetric(out, "piedock_cache_bytes", "gauge",
+		"Bytes of pixel data in cache", &Usage::bytes, nl);
+	writeMetric(out, "piedock_cache_hits_total", "counter",
+		"Number of look ups served from cache", &Usage::hits, nl);
+	writeMetric(out, "piedock_cache_misses_total", "counter",
+		"Number of look ups that had to create an entry",
+		&Usage::misses, nl);
+
+	unsigned long resident;
+
+	if ((resident = getResidentBytes())) {
+		out << "# HELP piedock_resident_bytes Resident set size" << nl <<
+			"# TYPE piedock_resident_bytes gauge" << nl <<
+			"piedock_resident_bytes " << resident << nl;
+	}
+}
+
+/**
+ * Return resident set size of this process or 0 if unknown
+ */
+unsigned long Statistics::getResidentBytes() {
+	FILE *fp;
+
+	if (!(fp = fopen("/proc/self/statm", "r"))) {
+		return 0;
+	}
+
+	unsigned long size;
+	unsigned long resident = 0;
+
+	if (fscanf(fp, "%lu %lu", &size, &resident) != 2) {
+		resident = 0;
+	}
+
+	fclose(fp);
+
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * Write one metric for every cache
+ *
+ * @param out - output stream
+ * @param name - metric name
+ * @param type - metric type
+ * @param help - description
+ * @param field - field of Usage
+ * @param nl - line terminator
+ */
+void Statistics::writeMetric(
+	std::ostream &out,
+	const char *name,
+	const char *type,
+	const char *help,
+	unsigned long Usage::*field,
+	char nl) const {
+	out << "# HELP " << name << " " << help << nl <<
+		"# TYPE " << name << " " << type << nl;
+
+	for (Caches::const_iterator i = caches.begin();
+			i != caches.end();
+			++i) {
+		out << name << "{cache=\"" << (*i).first << "\"} " <<
+			(*i).second.*field << nl;
+	}
+}
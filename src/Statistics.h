@@ -0,0 +1,34 @@
+#ifndef _PieDock_Statistics_
+#define _PieDock_Statistics_
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace PieDock {
+class Statistics {
+public:
+	typedef struct {
+		unsigned long entries;
+		unsigned long bytes;
+		unsigned long hits;
+		unsigned long misses;
+	} Usage;
+
+	Statistics() {}
+	virtual ~Statistics() {}
+	virtual void add(const std::string &, const Usage &);
+	virtual void write(std::ostream &, char = '\n') const;
+	static unsigned long getResidentBytes();
+
+private:
+	typedef std::vector<std::pair<std::string, Usage> > Caches;
+
+	Caches caches;
+
+	void writeMetric(std::ostream &, const char *, const char *,
+		const char *, unsigned long Usage::*, char) const;
+};
+}
+
+#endif
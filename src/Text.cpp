@@ -1,10 +1,13 @@
 #include "Application.h"
 #include "Text.h"
+#include "RequestCounter.h"
 
 #include <string.h>
 #include <stdio.h>
 
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <stdexcept>
 
 using namespace PieDock;
@@ -96,6 +99,25 @@ Text::Text(Display *d, Drawable da, Visual *v, Text::Font f) :
 #endif
 
 	setColor(f.getColor());
+
+	// text should always have the same height to avoid flickering
+	// so this is measured only once per font
+	lineMetrics = getMetrics("Ag");
+
+#ifdef HAVE_XFT
+	if (XftCharExists(display, xftFont, 0x2026)) {
+		ellipsis = "\xe2\x80\xa6";
+	} else
+#endif
+	{
+		ellipsis = "...";
+	}
+
+	ellipsisAdvance = 0;
+
+	for (std::string::size_type i = 0; i < ellipsis.length();) {
+		ellipsisAdvance += getAdvance(nextCharacter(ellipsis, i));
+	}
 }
 
 /**
@@ -149,7 +171,7 @@ Text::Metrics Text::getMetrics(const std::string s) const {
 #ifdef HAVE_XFT
 	XGlyphInfo extents;
 
-	XftTextExtents8(
+	XftTextExtentsUtf8(
 		display,
 		xftFont,
 		reinterpret_cast<const XftChar8 *>(s.c_str()),
@@ -167,6 +189,7 @@ Text::Metrics Text::getMetrics(const std::string s) const {
 	int descent;
 	XCharStruct overall;
 
+	RequestCounter::roundTrip();
 	XQueryTextExtents(
 		display,
 		fontInfo->fid,
@@ -185,6 +208,123 @@ Text::Metrics Text::getMetrics(const std::string s) const {
 #endif
 }
 
+/**
+ * Return horizontal advance of a character; advances are cached
+ * since a font never changes
+ *
+ * @param c - character
+ */
+int Text::getAdvance(unsigned int c) {
+	Advances::const_iterator i;
+
+	if ((i = advances.find(c)) != advances.end()) {
+		return (*i).second;
+	}
+
+#ifdef HAVE_XFT
+	FcChar32 ch = c;
+	XGlyphInfo extents;
+
+	XftTextExtents32(display, xftFont, &ch, 1, &extents);
+
+	return advances[c] = extents.xOff;
+#else
+	char ch = c;
+
+	return advances[c] = XTextWidth(fontInfo, &ch, 1);
+#endif
+}
+
+/**
+ * Return string shortened to fit into the given width; if the string
+ * needs to be shortened an ellipsis is appended
+ *
+ * @param s - some string
+ * @param width - available width in pixels
+ */
+std::string Text::fit(const std::string &s, int width) {
+	// widths[n] is the width of the first n characters which
+	// end at byte offsets[n]
+	std::vector<int> widths;
+	std::vector<std::string::size_type> offsets;
+	int total = 0;
+
+	widths.reserve(s.length() + 1);
+	offsets.reserve(s.length() + 1);
+	widths.push_back(0);
+	offsets.push_back(0);
+
+	for (std::string::size_type i = 0; i < s.length();) {
+		total += getAdvance(nextCharacter(s, i));
+		widths.push_back(total);
+		offsets.push_back(i);
+	}
+
+	if (total < width) {
+		return s;
+	}
+
+	// find the longest prefix that leaves room for the ellipsis
+	int n = std::lower_bound(
+		widths.begin(),
+		widths.end(),
+		width - ellipsisAdvance) - widths.begin() - 1;
+
+	if (n < 1) {
+		return "";
+	}
+
+	return s.substr(0, offsets[n]) + ellipsis;
+}
+
+/**
+ * Return character at the given byte offset and move the offset to
+ * the next character; without Xft every byte is a character
+ *
+ * @param s - some string
+ * @param i - byte offset
+ */
+unsigned int Text::nextCharacter(
+	const std::string &s,
+	std::string::size_type &i) {
+	unsigned char c = s[i++];
+
+#ifdef HAVE_XFT
+	int trailing;
+	unsigned int ch;
+
+	if (c < 0x80) {
+		return c;
+	} else if ((c & 0xe0) == 0xc0) {
+		trailing = 1;
+		ch = c & 0x1f;
+	} else if ((c & 0xf0) == 0xe0) {
+		trailing = 2;
+		ch = c & 0x0f;
+	} else if ((c & 0xf8) == 0xf0) {
+		trailing = 3;
+		ch = c & 0x07;
+	} else {
+		// stray continuation byte
+		return c;
+	}
+
+	for (; trailing-- && i < s.length(); ++i) {
+		unsigned char t = s[i];
+
+		if ((t & 0xc0) != 0x80) {
+			break;
+		}
+
+		ch = ch << 6 | (t & 0x3f);
+	}
+
+	return ch;
+#else
+	return c;
+#endif
+}
+
 /**
  * Transform color object into a XftColor
  *
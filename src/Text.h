@@ -8,6 +8,7 @@
 #endif
 
 #include <string>
+#include <map>
 
 namespace PieDock {
 class Text {
@@ -142,9 +143,20 @@ public:
 	virtual void setColor(const Color);
 	virtual void draw(const int, const int, const std::string) const;
 	virtual Metrics getMetrics(const std::string) const;
+	inline const Metrics &getLineMetrics() const {
+		return lineMetrics;
+	}
+	virtual int getAdvance(unsigned int);
+	virtual std::string fit(const std::string &, int);
 
 private:
+	typedef std::map<unsigned int, int> Advances;
+
 	Display *display;
+	Metrics lineMetrics;
+	Advances advances;
+	std::string ellipsis;
+	int ellipsisAdvance;
 #ifdef HAVE_XFT
 	XftFont *xftFont;
 	XftDraw *xftDraw;
@@ -156,6 +168,8 @@ private:
 	GC gc;
 #endif
 
+	static unsigned int nextCharacter(const std::string &,
+		std::string::size_type &);
 #ifdef HAVE_XFT
 	void translateColor(const Color &, XftColor *);
 #else
@@ -0,0 +1,160 @@
+#include "Timings.h"
+#include "ErrnoException.h"
+#include "RequestCounter.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <fstream>
+
+using namespace PieDock;
+
+const char *Timings::names[] = {
+	"trigger",
+	"show",
+	"prewarm",
+	"frame",
+	"menu_update",
+	"draw",
+	"layout",
+	"blend",
+	"resample",
+	"text_render",
+	"window_update",
+	"icon_lookup",
+	"client_update",
+	"round_trip",
+	"wait"
+};
+
+Timings::Histogram Timings::histograms[Timings::NumberOfIds];
+
+/**
+ * Write a line with count, percentiles and maximum in milliseconds for
+ * every histogram
+ *
+ * @param out - output stream
+ * @param nl - line terminator (optional)
+ */
+void Timings::report(std::ostream &out, char nl) {
+	for (int i = 0; i < NumberOfIds; ++i) {
+		const Histogram &h = histograms[i];
+
+		out << names[i] <<
+			" count " << h.getCount() <<
+			" p50_ms " << h.getPercentile(.5) * 1000.0 <<
+			" p99_ms " << h.getPercentile(.99) * 1000.0 <<
+			" max_ms " << h.getMax() * 1000.0 <<
+			" total_ms " << h.getSum() * 1000.0 << nl;
+	}
+
+	RequestCounter::report(out, nl);
+}
+
+/**
+ * Write report into a file
+ *
+ * @param file - file name
+ */
+void Timings::dump(const std::string &file) {
+	std::ofstream out(file.c_str());
+
+	if (!out.good()) {
+		throw ErrnoException();
+	}
+
+	report(out);
+}
+
+/**
+ * Drop all recorded values
+ */
+void Timings::reset() {
+	for (int i = 0; i < NumberOfIds; ++i) {
+		histograms[i].reset();
+	}
+
+	RequestCounter::reset();
+}
+
+/**
+ * Add a value
+ *
+ * @param seconds - duration in seconds
+ */
+void Timings::Histogram::add(double seconds) {
+	++buckets[getBucket(seconds)];
+	++count;
+	sum += seconds;
+
+	if (seconds > max) {
+		max = seconds;
+	}
+}
+
+/**
+ * Drop all values
+ */
+void Timings::Histogram::reset() {
+	memset(buckets, 0, sizeof(buckets));
+	count = 0;
+	sum = 0;
+	max = 0;
+}
+
+/**
+ * Return upper bound of the bucket that holds the given percentile;
+ * the result is never larger than the maximum
+ *
+ * @param p - percentile from 0 to 1
+ */
+double Timings::Histogram::getPercentile(double p) const {
+	if (!count) {
+		return 0;
+	}
+
+	unsigned long rank = static_cast<unsigned long>(ceil(p * count));
+
+	if (rank < 1) {
+		rank = 1;
+	}
+
+	unsigned long n = 0;
+
+	for (int b = 0; b < Buckets; ++b) {
+		if ((n += buckets[b]) >= rank) {
+			double bound = getUpperBound(b);
+
+			return bound < max ? bound : max;
+		}
+	}
+
+	return max;
+}
+
+/**
+ * Return bucket for a duration; buckets start at one microsecond and
+ * grow by a quarter octave
+ *
+ * @param seconds - duration in seconds
+ */
+int Timings::Histogram::getBucket(double seconds) {
+	double us = seconds * 1000000.0;
+
+	if (us <= 1.0) {
+		return 0;
+	}
+
+	int b = static_cast<int>(ceil(log2(us) * StepsPerOctave));
+
+	return b < Buckets ? b : Buckets - 1;
+}
+
+/**
+ * Return largest duration of a bucket in seconds
+ *
+ * @param b - bucket
+ */
+double Timings::Histogram::getUpperBound(int b) {
+	return pow(2.0, static_cast<double>(b) / StepsPerOctave) / 1000000.0;
+}
@@ -0,0 +1,114 @@
+#ifndef _PieDock_Timings_
+#define _PieDock_Timings_
+
+#include "FrameScheduler.h"
+#include "Trace.h"
+
+#include <string>
+#include <ostream>
+
+namespace PieDock {
+class Timings {
+public:
+	enum Id {
+		Trigger,
+		Show,
+		Prewarm,
+		Frame,
+		MenuUpdate,
+		Draw,
+		Layout,
+		Blend,
+		Resample,
+		TextRender,
+		WindowUpdate,
+		IconLookup,
+		ClientUpdate,
+		RoundTrip,
+		Wait,
+		NumberOfIds
+	};
+
+	/**
+	 * Logarithmic latency histogram
+	 */
+	class Histogram {
+	public:
+		Histogram() {
+			reset();
+		}
+		virtual ~Histogram() {}
+		inline const unsigned long &getCount() const {
+			return count;
+		}
+		inline const double &getSum() const {
+			return sum;
+		}
+		inline const double &getMax() const {
+			return max;
+		}
+		void add(double);
+		void reset();
+		double getPercentile(double) const;
+
+	private:
+		enum {
+			Buckets = 128,
+			StepsPerOctave = 4
+		};
+
+		unsigned long buckets[Buckets];
+		unsigned long count;
+		double sum;
+		double max;
+
+		static int getBucket(double);
+		static double getUpperBound(int);
+	};
+
+	/**
+	 * Record time from construction to destruction; the span is also
+	 * written as trace event if tracing is enabled
+	 */
+	class Span {
+	public:
+		Span(Id i, int v = -1) :
+			id(i),
+			value(v),
+			start(FrameScheduler::now()) {}
+		virtual ~Span() {
+			double duration = FrameScheduler::now() - start;
+
+			record(id, duration);
+
+			if (Trace::isEnabled()) {
+				Trace::add(names[id], start, duration, value);
+			}
+		}
+
+	private:
+		Id id;
+		int value;
+		double start;
+	};
+
+	static inline void record(Id i, double seconds) {
+		histograms[i].add(seconds);
+	}
+	static inline const Histogram &getHistogram(Id i) {
+		return histograms[i];
+	}
+	static inline const char *getName(Id i) {
+		return names[i];
+	}
+	static void report(std::ostream &, char = '\n');
+	static void dump(const std::string &);
+	static void reset();
+
+private:
+	static const char *names[];
+	static Histogram histograms[];
+};
+}
+
+#endif
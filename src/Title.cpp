@@ -0,0 +1,154 @@
+#include "Title.h"
+#include "Cartouche.h"
+#include "RequestCounter.h"
+
+#include <X11/Xutil.h>
+
+#include <stdint.h>
+
+using namespace PieDock;
+
+/**
+ * Render title into a cartouche; the result can be blended like
+ * an icon
+ *
+ * @param d - display
+ * @param scratch - drawable text is rendered into, must be at least as
+ *                  large as the title and have the depth of the visual
+ * @param gc - graphics context for scratch
+ * @param visual - visual of scratch
+ * @param text - text object that draws white text into scratch
+ * @param m - metrics of title
+ * @param title - title
+ * @param color - text color
+ * @param radius - corner radius of cartouche
+ * @param alpha - opacity of cartouche
+ * @param background - color of cartouche
+ */
+Title::Title(
+	Display *d,
+	Drawable scratch,
+	GC gc,
+	Visual *visual,
+	const Text &text,
+	const Text::Metrics &m,
+	const std::string &title,
+	const Text::Color &color,
+	int radius,
+	int alpha,
+	unsigned int background) :
+	ArgbSurface(
+		m.getWidth() + (radius << 1) + radius,
+		m.getHeight() + (radius << 1) + radius) {
+	// bake opacity of cartouche into its color
+	Cartouche::draw(*this, radius, getCartoucheColor(alpha, background));
+
+	drawText(d, scratch, gc, visual, text, m, title, color);
+}
+
+/**
+ * Render cartouche corners in advance
+ *
+ * @param radius - corner radius of cartouche
+ * @param alpha - opacity of cartouche
+ * @param background - color of cartouche
+ */
+void Title::prepare(int radius, int alpha, unsigned int background) {
+	Cartouche::prepare(radius, getCartoucheColor(alpha, background));
+}
+
+/**
+ * Draw text over cartouche; since Xft requires a Drawable, the glyphs
+ * are rendered white on black into scratch and read back to be used
+ * as coverage
+ *
+ * @param d - display
+ * @param scratch - drawable text is rendered into
+ * @param gc - graphics context for scratch
+ * @param visual - visual of scratch
+ * @param text - text object that draws white text into scratch
+ * @param m - metrics of title
+ * @param title - title
+ * @param color - text color
+ */
+void Title::drawText(
+	Display *d,
+	Drawable scratch,
+	GC gc,
+	Visual *visual,
+	const Text &text,
+	const Text::Metrics &m,
+	const std::string &title,
+	const Text::Color &color) {
+	const int width = getWidth();
+	const int height = getHeight();
+
+	XSetForeground(d, gc, 0);
+	XFillRectangle(d, scratch, gc, 0, 0, width, height);
+
+	text.draw(
+		((width - m.getWidth()) >> 1) + m.getX(),
+		((height - m.getHeight()) >> 1) + m.getY(),
+		title);
+
+	XImage *image;
+
+	RequestCounter::roundTrip();
+
+	if (!(image = XGetImage(
+			d,
+			scratch,
+			0,
+			0,
+			width,
+			height,
+			AllPlanes,
+			ZPixmap))) {
+		return;
+	}
+
+	// use the green channel as coverage since it has the most bits
+	// on all common visuals
+	unsigned long mask = visual->green_mask;
+	int shift = 0;
+
+	for (; mask && !(mask & 1); mask >>= 1, ++shift);
+
+	const uint32_t rgb = color.getColor() & 0xffffff;
+	uint32_t *p = reinterpret_cast<uint32_t *>(getData());
+
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x, ++p) {
+			unsigned long pixel = XGetPixel(image, x, y);
+			int coverage = mask ?
+				((pixel >> shift) & mask) * 0xff / mask :
+				(pixel ? 0xff : 0);
+
+			if (!coverage) {
+				continue;
+			}
+
+			// text over cartouche
+			int ta = coverage * color.getAlpha() / 0xff;
+			int ca = (*p >> 24) * (0xff - ta) / 0xff;
+			int a = ta + ca;
+
+			if (!a) {
+				continue;
+			}
+
+			uint32_t result = a << 24;
+
+			for (int s = 0; s < 24; s += 8) {
+				int tc = (rgb >> s) & 0xff;
+				int cc = (*p >> s) & 0xff;
+
+				result |= ((tc * ta + cc * ca) / a) << s;
+			}
+
+			*p = result;
+		}
+	}
+
+	XDestroyImage(image);
+}
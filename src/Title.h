@@ -0,0 +1,32 @@
+#ifndef _PieDock_Title_
+#define _PieDock_Title_
+
+#include "ArgbSurface.h"
+#include "Text.h"
+
+#include <X11/Xlib.h>
+
+#include <string>
+
+namespace PieDock {
+class Title : public ArgbSurface {
+public:
+	Title(Display *, Drawable, GC, Visual *, const Text &,
+		const Text::Metrics &, const std::string &, const Text::Color &,
+		int, int, unsigned int);
+	virtual ~Title() {}
+	static void prepare(int, int, unsigned int);
+
+protected:
+	static inline unsigned int getCartoucheColor(
+		int alpha,
+		unsigned int background) {
+		return ((background >> 24) * alpha / 0xff) << 24 |
+			(background & 0xffffff);
+	}
+	virtual void drawText(Display *, Drawable, GC, Visual *, const Text &,
+		const Text::Metrics &, const std::string &, const Text::Color &);
+};
+}
+
+#endif
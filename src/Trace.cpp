@@ -0,0 +1,103 @@
+#include "Trace.h"
+#include "FrameScheduler.h"
+#include "ErrnoException.h"
+
+#include <unistd.h>
+
+using namespace PieDock;
+
+std::ofstream *Trace::out = 0;
+unsigned long Trace::frame = 0;
+double Trace::origin = 0;
+int Trace::pid = 0;
+bool Trace::empty = true;
+
+/**
+ * Start writing trace events in Chrome's JSON array format into
+ * the given file; the file can be opened in Perfetto or about:tracing
+ *
+ * @param file - file name
+ */
+void Trace::open(const std::string &file) {
+	close();
+
+	out = new std::ofstream(file.c_str());
+
+	if (!out->good()) {
+		delete out;
+		out = 0;
+		throw ErrnoException();
+	}
+
+	origin = FrameScheduler::now();
+	empty = true;
+	pid = getpid();
+
+	*out << "[";
+	out->setf(std::ios::fixed);
+	out->precision(3);
+}
+
+/**
+ * Stop writing trace events
+ */
+void Trace::close() {
+	if (!out) {
+		return;
+	}
+
+	*out << "\n]" << std::endl;
+
+	delete out;
+	out = 0;
+}
+
+/**
+ * Add a complete event
+ *
+ * @param name - name of event
+ * @param start - start time in seconds
+ * @param duration - duration in seconds
+ * @param value - some number that identifies the instance, like the
+ *                size of an icon (optional)
+ */
+void Trace::add(const char *name, double start, double duration, int value) {
+	if (!out) {
+		return;
+	}
+
+	*out << (empty ? "\n" : ",\n") <<
+		"{\"name\":\"" << name <<
+		"\",\"ph\":\"X\",\"pid\":" << pid <<
+		",\"tid\":" << pid <<
+		",\"ts\":" << (start - origin) * 1000000.0 <<
+		",\"dur\":" << duration * 1000000.0 <<
+		",\"args\":{\"frame\":" << frame;
+
+	if (value > -1) {
+		*out << ",\"value\":" << value;
+	}
+
+	*out << "}}";
+	empty = false;
+}
+
+/**
+ * Add a counter event
+ *
+ * @param name - name of counter
+ * @param time - time in seconds
+ * @param value - value of counter
+ */
+void Trace::addCounter(const char *name, double time, unsigned long value) {
+	if (!out) {
+		return;
+	}
+
+	*out << (empty ? "\n" : ",\n") <<
+		"{\"name\":\"" << name <<
+		"\",\"ph\":\"C\",\"pid\":" << pid <<
+		",\"ts\":" << (time - origin) * 1000000.0 <<
+		",\"args\":{\"value\":" << value << "}}";
+	empty = false;
+}
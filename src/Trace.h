@@ -0,0 +1,33 @@
+#ifndef _PieDock_Trace_
+#define _PieDock_Trace_
+
+#include <string>
+#include <fstream>
+
+namespace PieDock {
+class Trace {
+public:
+	static inline bool isEnabled() {
+		return out != 0;
+	}
+	static inline const unsigned long &getFrame() {
+		return frame;
+	}
+	static inline void nextFrame() {
+		++frame;
+	}
+	static void open(const std::string &);
+	static void close();
+	static void add(const char *, double, double, int = -1);
+	static void addCounter(const char *, double, unsigned long);
+
+private:
+	static std::ofstream *out;
+	static unsigned long frame;
+	static double origin;
+	static int pid;
+	static bool empty;
+};
+}
+
+#endif
@@ -1,4 +1,6 @@
 #include "TransparentWindow.h"
+#include "Timings.h"
+#include "RequestCounter.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -12,9 +14,11 @@ using namespace PieDock;
  * Initialize object
  *
  * @param a - Application object
+ * @param s - screen number, if not given the default screen (optional)
  */
-TransparentWindow::TransparentWindow(Application &a) :
+TransparentWindow::TransparentWindow(Application &a, int s) :
 		app(&a),
+		screen(s < 0 ? DefaultScreen(a.getDisplay()) : s),
 		width(app->getSettings()->getWidth()),
 		height(app->getSettings()->getHeight()),
 		canvas(0),
@@ -72,7 +76,7 @@ TransparentWindow::TransparentWindow(Application &a) :
 
 			if (!XMatchVisualInfo(
 					app->getDisplay(),
-					DefaultScreen(app->getDisplay()),
+					screen,
 					depth,
 					TrueColor,
 					&vi)) {
@@ -86,7 +90,7 @@ TransparentWindow::TransparentWindow(Application &a) :
 			xswat.border_pixel = 0x00000000;
 			xswat.colormap = XCreateColormap(
 				app->getDisplay(),
-				DefaultRootWindow(app->getDisplay()),
+				RootWindow(app->getDisplay(), screen),
 				visual,
 				AllocNone);
 
@@ -96,7 +100,7 @@ TransparentWindow::TransparentWindow(Application &a) :
 #endif
 
 	if (!(window = XCreateWindow(app->getDisplay(),
-			DefaultRootWindow(app->getDisplay()),
+			RootWindow(app->getDisplay(), screen),
 			0,
 			0,
 			width,
@@ -140,8 +144,6 @@ TransparentWindow::TransparentWindow(Application &a) :
 #endif
 		// fall back to default values
 	{
-		int screen = DefaultScreen(app->getDisplay());
-
 		visual = DefaultVisual(app->getDisplay(), screen);
 		depth = DefaultDepth(app->getDisplay(), screen);
 	}
@@ -191,6 +193,15 @@ TransparentWindow::~TransparentWindow() {
 	XDestroyWindow(app->getDisplay(), window);
 }
 
+/**
+ * Touch offscreen memory so its pages are faulted in before the
+ * first frame is drawn
+ */
+void TransparentWindow::prepare() {
+	memset(canvas->getData(), 0, canvas->getSize());
+	memset(buffer, 0, canvas->getSize());
+}
+
 /**
  * Show window; the caller must ensure that the window is completely
  * visible on the screen or XGetSubImage will fail !
@@ -205,6 +216,9 @@ void TransparentWindow::show() {
 	}
 #endif
 
+	Timings::Span span(Timings::RoundTrip);
+
+	RequestCounter::roundTrip();
 	XGetSubImage(
 		app->getDisplay(),
 		window,
@@ -256,6 +270,9 @@ void TransparentWindow::clear() {
  * Update window
  */
 void TransparentWindow::update() const {
+	Timings::Span span(Timings::WindowUpdate);
+	RequestCounter::Scope scope(app->getDisplay(), RequestCounter::Upload);
+
 #ifdef HAVE_XRENDER
 	if (app->getSettings()->useCompositing()) {
 		XPutImage(
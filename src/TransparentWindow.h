@@ -13,16 +13,20 @@
 namespace PieDock {
 class TransparentWindow {
 public:
-	TransparentWindow(Application &);
+	TransparentWindow(Application &, int = -1);
 	virtual ~TransparentWindow();
 	inline const Window &getWindow() const {
 		return window;
 	}
+	inline const int &getScreen() const {
+		return screen;
+	}
 	virtual void appear() {}
 	virtual void draw() {}
 	virtual bool processEvent(XEvent &) {
 		return false;
 	}
+	virtual void prepare();
 
 protected:
 	inline Application *getApp() const {
@@ -68,6 +72,7 @@ protected:
 
 private:
 	Application *app;
+	int screen;
 	Window window;
 	int width;
 	int height;
@@ -0,0 +1,142 @@
+#include "TriggerGrabs.h"
+
+using namespace PieDock;
+
+/**
+ * Compare grabs
+ *
+ * @param g - other grab
+ */
+bool TriggerGrabs::Grab::operator<(const Grab &g) const {
+	if (type != g.type) {
+		return type < g.type;
+	} else if (code != g.code) {
+		return code < g.code;
+	}
+
+	return modifier < g.modifier;
+}
+
+/**
+ * Initialize grab set; nothing is grabbed until update() is called
+ *
+ * @param d - display
+ * @param r - root window
+ */
+TriggerGrabs::TriggerGrabs(Display *d, Window r) :
+	display(d),
+	root(r) {
+}
+
+/**
+ * Bring installed grabs in line with the triggers of the given settings;
+ * only grabs that have changed are sent to the X server
+ *
+ * @param settings - settings
+ */
+void TriggerGrabs::update(Settings &settings) {
+	GrabToMask wanted;
+
+	for (Settings::Keys::iterator i = settings.getKeys().begin();
+			i != settings.getKeys().end();
+			++i) {
+		Grab g = { KeyPress, (*i).keyCode, (*i).modifier };
+
+		wanted[g] = KeyPressMask;
+	}
+
+	// grabbing the same button and modifier again replaces
+	// the previous grab so event masks need to be merged
+	for (Settings::Buttons::iterator i = settings.getButtons().begin();
+			i != settings.getButtons().end();
+			++i) {
+		Grab g = { ButtonPress, (*i).button, (*i).modifier };
+
+		wanted[g] |= (*i).eventMask;
+	}
+
+	for (GrabToMask::iterator i = grabs.begin();
+			i != grabs.end();
+			++i) {
+		if (wanted.find((*i).first) == wanted.end()) {
+			ungrab((*i).first);
+		}
+	}
+
+	for (GrabToMask::iterator i = wanted.begin();
+			i != wanted.end();
+			++i) {
+		GrabToMask::iterator g = grabs.find((*i).first);
+
+		if (g == grabs.end() || (*g).second != (*i).second) {
+			grab((*i).first, (*i).second);
+		}
+	}
+
+	grabs.swap(wanted);
+}
+
+/**
+ * Remove all grabs
+ */
+void TriggerGrabs::clear() {
+	for (GrabToMask::iterator i = grabs.begin();
+			i != grabs.end();
+			++i) {
+		ungrab((*i).first);
+	}
+
+	grabs.clear();
+}
+
+/**
+ * Install grab
+ *
+ * @param g - grab
+ * @param eventMask - event mask for buttons
+ */
+void TriggerGrabs::grab(const Grab &g, unsigned int eventMask) {
+	if (g.type == KeyPress) {
+		XGrabKey(
+			display,
+			g.code,
+			g.modifier,
+			root,
+			True,
+			GrabModeAsync,
+			GrabModeAsync);
+	} else {
+		XGrabButton(
+			display,
+			g.code,
+			g.modifier,
+			root,
+			True,
+			eventMask,
+			GrabModeAsync,
+			GrabModeAsync,
+			None,
+			None);
+	}
+}
+
+/**
+ * Remove grab
+ *
+ * @param g - grab
+ */
+void TriggerGrabs::ungrab(const Grab &g) {
+	if (g.type == KeyPress) {
+		XUngrabKey(
+			display,
+			g.code,
+			g.modifier,
+			root);
+	} else {
+		XUngrabButton(
+			display,
+			g.code,
+			g.modifier,
+			root);
+	}
+}
@@ -0,0 +1,38 @@
+#ifndef _PieDock_TriggerGrabs_
+#define _PieDock_TriggerGrabs_
+
+#include "Settings.h"
+
+#include <X11/Xlib.h>
+
+#include <map>
+
+namespace PieDock {
+class TriggerGrabs {
+public:
+	TriggerGrabs(Display *, Window);
+	virtual ~TriggerGrabs() {}
+	virtual void update(Settings &);
+	virtual void clear();
+
+private:
+	typedef struct Grab {
+		int type;
+		unsigned int code;
+		unsigned int modifier;
+
+		bool operator<(const Grab &) const;
+	} Grab;
+
+	typedef std::map<Grab, unsigned int> GrabToMask;
+
+	Display *display;
+	Window root;
+	GrabToMask grabs;
+
+	void grab(const Grab &, unsigned int);
+	void ungrab(const Grab &);
+};
+}
+
+#endif
@@ -16,6 +16,8 @@
 using namespace PieDock;
 
 WindowManager::StringToAtom WindowManager::stringToAtom;
+WindowManager::FrameToClient WindowManager::frameToClient;
+WindowManager::ClientToFrame WindowManager::clientToFrame;
 
 /**
  * Add client of given display
@@ -86,6 +88,7 @@ void WindowManager::activate(Display *d, Window w) {
 			usleep(1000)) {
 		XWindowAttributes wa;
 
+		RequestCounter::roundTrip();
 		XGetWindowAttributes(d, w, &wa);
 
 		if (wa.map_state != IsViewable) {
@@ -134,7 +137,9 @@ Window WindowManager::getActive(Display *d) {
 }
 
 /**
- * Get client/content window from a possible frame/decor window
+ * Get client/content window from a possible frame/decor window; results
+ * are cached until forgetClientWindow() is called for the frame or the
+ * client
  *
  * @param d - display
  * @param w - window
@@ -144,8 +149,24 @@ Window WindowManager::getClientWindow(Display *d, Window w) {
 	int i;
 	unsigned int u;
 
-	if (w && w != DefaultRootWindow(d) &&
-			XGetGeometry(d, w, &root, &i, &i, &u, &u, &u, &u)) {
+	if (!w || w == DefaultRootWindow(d)) {
+		return w;
+	}
+
+	// cache look up
+	{
+		FrameToClient::iterator f;
+
+		if ((f = frameToClient.find(w)) != frameToClient.end()) {
+			return (*f).second;
+		}
+	}
+
+	RequestCounter::roundTrip();
+
+	if (XGetGeometry(d, w, &root, &i, &i, &u, &u, &u, &u)) {
+		Window frame = w;
+
 #ifdef HAVE_XMU
 		w = XmuClientWindow(d, w);
 #else
@@ -173,6 +194,8 @@ Window WindowManager::getClientWindow(Display *d, Window w) {
 				Window *children;
 				unsigned int n;
 
+				RequestCounter::roundTrip();
+
 				if (!XQueryTree(display, window, &root, &parent,
 						&children, &n)) {
 					return 0;
@@ -204,13 +227,66 @@ Window WindowManager::getClientWindow(Display *d, Window w) {
 		};
 
 		WindowDiver wd(d);
-		return wd.find(w);
+		w = wd.find(w);
 #endif
+
+		// a client that is destroyed or reparented within its frame
+		// is only reported to listeners of the client window itself;
+		// ClientMap selects StructureNotify on all clients
+		frameToClient[frame] = w;
+		clientToFrame.insert(std::make_pair(w, frame));
 	}
 
 	return w;
 }
 
+/**
+ * Drop cached frame to client mappings that involve the given window;
+ * to be called on ReparentNotify and DestroyNotify
+ *
+ * @param w - frame or client window
+ */
+void WindowManager::forgetClientWindow(Window w) {
+	// w is a frame
+	{
+		FrameToClient::iterator f;
+
+		if ((f = frameToClient.find(w)) != frameToClient.end()) {
+			std::pair<ClientToFrame::iterator, ClientToFrame::iterator> r =
+				clientToFrame.equal_range((*f).second);
+
+			for (ClientToFrame::iterator i = r.first; i != r.second; ++i) {
+				if ((*i).second == w) {
+					clientToFrame.erase(i);
+					break;
+				}
+			}
+
+			frameToClient.erase(f);
+		}
+	}
+
+	// w is a client
+	{
+		std::pair<ClientToFrame::iterator, ClientToFrame::iterator> r =
+			clientToFrame.equal_range(w);
+
+		for (ClientToFrame::iterator i = r.first; i != r.second; ++i) {
+			frameToClient.erase((*i).second);
+		}
+
+		clientToFrame.erase(r.first, r.second);
+	}
+}
+
+/**
+ * Drop all cached frame to client mappings
+ */
+void WindowManager::forgetClientWindows() {
+	frameToClient.clear();
+	clientToFrame.clear();
+}
+
 /**
  * Return (visible) title of some window
  *
@@ -489,5 +565,7 @@ Atom WindowManager::getAtom(Display *d, const char *n) {
 		return (*i).second;
 	}
 
+	RequestCounter::roundTrip();
+
 	return (stringToAtom[n] = XInternAtom(d, n, False));
 }
@@ -1,6 +1,8 @@
 #ifndef _PieDock_WindowManager_
 #define _PieDock_WindowManager_
 
+#include "RequestCounter.h"
+
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
 
@@ -33,6 +35,8 @@ public:
 	static void close(Display *, Window);
 	static Window getActive(Display *);
 	static Window getClientWindow(Display *, Window);
+	static void forgetClientWindow(Window);
+	static void forgetClientWindows();
 	static std::string getTitle(Display *, Window);
 	static ArgbSurface *getIcon(Display *, Window);
 	static unsigned long getWorkspace(Display *, Window);
@@ -78,6 +82,8 @@ private:
 			XErrorHandler defaultHandler =
 				XSetErrorHandler(ignoreHandler);
 
+			RequestCounter::roundTrip();
+
 			if (XGetWindowProperty(
 					display,
 					window,
@@ -127,6 +133,10 @@ private:
 
 	typedef std::map<std::string, Atom> StringToAtom;
 	static StringToAtom stringToAtom;
+	typedef std::map<Window, Window> FrameToClient;
+	static FrameToClient frameToClient;
+	typedef std::multimap<Window, Window> ClientToFrame;
+	static ClientToFrame clientToFrame;
 
 	WindowManager() {}
 	WindowManager &operator=(const WindowManager &) {
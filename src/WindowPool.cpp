@@ -0,0 +1,224 @@
+#include "WindowPool.h"
+#include "Hotspot.h"
+
+using namespace PieDock;
+
+/**
+ * Initialize window pool; windows are created by fill() or on demand
+ *
+ * @param a - Application object
+ */
+WindowPool::WindowPool(Application &a) :
+	app(&a) {
+}
+
+/**
+ * Clean up
+ */
+WindowPool::~WindowPool() {
+	clear();
+}
+
+/**
+ * Create and prepare a window on every screen for every menu that can
+ * be opened by a trigger or through the control socket so showing such
+ * a menu never needs to set up rendering resources; windows for other
+ * menus are created on demand by getWindow()
+ */
+void WindowPool::fill() {
+	Settings *settings = app->getSettings();
+	Names names;
+
+	// sub menus are named "menu/sub" and entered within the window
+	// of their parent
+	for (Settings::Menus::iterator m = settings->getMenus().begin();
+			m != settings->getMenus().end();
+			++m) {
+		if ((*m).first.find('/') == std::string::npos) {
+			names.insert((*m).first);
+		}
+	}
+
+	addTriggerMenus(names);
+
+	for (int s = 0, n = ScreenCount(app->getDisplay()); s < n; ++s) {
+		for (Names::iterator i = names.begin();
+				i != names.end();
+				++i) {
+			getWindow(*i, s)->prepare();
+		}
+	}
+}
+
+/**
+ * Destroy all windows
+ */
+void WindowPool::clear() {
+	for (KeyToWindow::iterator i = windows.begin();
+			i != windows.end();
+			++i) {
+		delete (*i).second;
+	}
+
+	windows.clear();
+}
+
+/**
+ * Destroy windows of menus that are neither configured nor opened by
+ * a trigger anymore
+ */
+void WindowPool::prune() {
+	Settings::Menus *menus = &app->getSettings()->getMenus();
+	Names names;
+
+	addTriggerMenus(names);
+
+	KeyToWindow::iterator i = windows.begin();
+
+	while (i != windows.end()) {
+		const std::string &name = (*i).first.second;
+
+		if (menus->find(name) == menus->end() &&
+				names.find(name) == names.end()) {
+			delete (*i).second;
+			windows.erase(i++);
+		} else {
+			++i;
+		}
+	}
+}
+
+/**
+ * Drop references to menu items of the current settings; to be called
+ * before the settings are replaced
+ */
+void WindowPool::forgetMenuItems() {
+	for (KeyToWindow::iterator i = windows.begin();
+			i != windows.end();
+			++i) {
+		(*i).second->forgetMenuItems();
+	}
+}
+
+/**
+ * Make every menu forget a menu item that is about to be deleted; menu
+ * items are shared by all windows
+ *
+ * @param item - menu item
+ */
+void WindowPool::deselect(MenuItem *item) {
+	for (KeyToWindow::iterator i = windows.begin();
+			i != windows.end();
+			++i) {
+		(*i).second->deselect(item);
+	}
+}
+
+/**
+ * Bring menus up to date; menu items and icons are shared by all
+ * windows, so it's sufficient to do that once
+ */
+void WindowPool::prewarm() {
+	getAnyWindow()->prewarm();
+}
+
+/**
+ * Bring a single menu up to date; returns false if there is no such menu
+ *
+ * @param menuName - menu name
+ */
+bool WindowPool::prewarm(const std::string &menuName) {
+	return getAnyWindow()->prewarm(menuName);
+}
+
+/**
+ * Add number, size and look ups of cached titles of all windows
+ * to usage
+ *
+ * @param u - usage
+ */
+void WindowPool::addTitlesUsage(Statistics::Usage &u) const {
+	for (KeyToWindow::const_iterator i = windows.begin();
+			i != windows.end();
+			++i) {
+		(*i).second->addTitlesUsage(u);
+	}
+}
+
+/**
+ * Return window for some menu, the window is created if there is none
+ * yet
+ *
+ * @param menuName - menu name
+ * @param screen - screen number, if not given the screen that contains
+ *                 the mouse pointer (optional)
+ */
+PieMenuWindow *WindowPool::getWindow(std::string menuName, int screen) {
+	if (screen < 0) {
+		screen = getPointerScreen();
+	}
+
+	Key key(screen, menuName);
+	KeyToWindow::iterator i;
+
+	if ((i = windows.find(key)) != windows.end()) {
+		return (*i).second;
+	}
+
+	return windows[key] = new PieMenuWindow(*app, screen);
+}
+
+/**
+ * Return number of the screen that contains the mouse pointer
+ */
+int WindowPool::getPointerScreen() const {
+	Display *d = app->getDisplay();
+	int n = ScreenCount(d);
+
+	// save the round trip on single screen setups
+	if (n < 2) {
+		return DefaultScreen(d);
+	}
+
+	Hotspot p(d);
+
+	for (int s = 0; s < n; ++s) {
+		if (RootWindow(d, s) == p.getRoot()) {
+			return s;
+		}
+	}
+
+	return DefaultScreen(d);
+}
+
+/**
+ * Return some window of the pool
+ */
+PieMenuWindow *WindowPool::getAnyWindow() {
+	if (windows.empty()) {
+		return getWindow("");
+	}
+
+	return (*windows.begin()).second;
+}
+
+/**
+ * Add names of all menus that are opened by triggers
+ *
+ * @param names - menu names
+ */
+void WindowPool::addTriggerMenus(Names &names) const {
+	Settings *settings = app->getSettings();
+
+	for (Settings::Keys::iterator k = settings->getKeys().begin();
+			k != settings->getKeys().end();
+			++k) {
+		names.insert((*k).menuName);
+	}
+
+	for (Settings::Buttons::iterator b = settings->getButtons().begin();
+			b != settings->getButtons().end();
+			++b) {
+		names.insert((*b).menuName);
+	}
+}
@@ -0,0 +1,45 @@
+#ifndef _PieDock_WindowPool_
+#define _PieDock_WindowPool_
+
+#include "Application.h"
+#include "PieMenuWindow.h"
+
+#include <X11/Xlib.h>
+
+#include <string>
+#include <map>
+#include <set>
+
+namespace PieDock {
+class WindowPool {
+public:
+	WindowPool(Application &);
+	virtual ~WindowPool();
+	virtual void fill();
+	virtual void clear();
+	virtual void prune();
+	virtual void forgetMenuItems();
+	virtual void deselect(MenuItem *);
+	inline int getNumberOfWindows() const {
+		return windows.size();
+	}
+	virtual void prewarm();
+	virtual bool prewarm(const std::string &);
+	virtual void addTitlesUsage(Statistics::Usage &) const;
+	virtual PieMenuWindow *getWindow(std::string, int = -1);
+	int getPointerScreen() const;
+
+private:
+	typedef std::pair<int, std::string> Key;
+	typedef std::map<Key, PieMenuWindow *> KeyToWindow;
+	typedef std::set<std::string> Names;
+
+	Application *app;
+	KeyToWindow windows;
+
+	PieMenuWindow *getAnyWindow();
+	void addTriggerMenus(Names &) const;
+};
+}
+
+#endif
@@ -12,11 +12,62 @@ using namespace PieDock;
 void WindowStack::addWindow(Display *d, Window w) {
 	WindowInfo wa = { w };
 
+	RequestCounter::roundTrip();
 	XGetWindowAttributes(d, w, &wa.attributes);
 
 	windowInfos.push_back(wa);
 }
 
+/**
+ * Add a window with known attributes to menu item
+ *
+ * @param w - window to add
+ * @param wa - window attributes
+ */
+void WindowStack::addWindow(Window w, const XWindowAttributes &wa) {
+	WindowInfo wi = { w, wa };
+
+	windowInfos.push_back(wi);
+}
+
+/**
+ * Update attributes of a window in place; returns false if the window
+ * isn't part of this stack
+ *
+ * @param w - window to update
+ * @param wa - window attributes
+ */
+bool WindowStack::updateWindow(Window w, const XWindowAttributes &wa) {
+	for (WindowInfos::iterator i = windowInfos.begin();
+			i != windowInfos.end();
+			++i) {
+		if ((*i).window == w) {
+			(*i).attributes = wa;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Remove a window; returns false if the window isn't part of this stack
+ *
+ * @param w - window to remove
+ */
+bool WindowStack::removeWindow(Window w) {
+	for (WindowInfos::iterator i = windowInfos.begin();
+			i != windowInfos.end();
+			++i) {
+		if ((*i).window == w) {
+			windowInfos.erase(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
 /**
  * Return next window
  */
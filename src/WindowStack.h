@@ -27,6 +27,9 @@ public:
 		windowInfos.clear();
 	}
 	void addWindow(Display *, Window);
+	void addWindow(Window, const XWindowAttributes &);
+	bool updateWindow(Window, const XWindowAttributes &);
+	bool removeWindow(Window);
 	const Window getNextWindow();
 	const Window getPreviousWindow();
 	const bool isUnmapped();
@@ -0,0 +1,370 @@
+#include "WorkspaceIconMap.h"
+#include "Cartouche.h"
+#include "Blender.h"
+
+#include <string.h>
+
+using namespace PieDock;
+
+/**
+ * Compare keys
+ *
+ * @param k - other key
+ */
+bool WorkspaceIconMap::Key::operator<(const Key &k) const {
+	if (icon != k.icon) {
+		return icon < k.icon;
+	} else if (type != k.type) {
+		return type < k.type;
+	} else if (workspaceColor != k.workspaceColor) {
+		return workspaceColor < k.workspaceColor;
+	} else if (windowColor != k.windowColor) {
+		return windowColor < k.windowColor;
+	}
+
+	return memcmp(windows, k.windows, sizeof(windows)) < 0;
+}
+
+/**
+ * Compare keys
+ *
+ * @param k - other key
+ */
+bool WorkspaceIconMap::GridKey::operator<(const GridKey &k) const {
+	if (width != k.width) {
+		return width < k.width;
+	} else if (height != k.height) {
+		return height < k.height;
+	}
+
+	return color < k.color;
+}
+
+/**
+ * Initialize map
+ */
+WorkspaceIconMap::WorkspaceIconMap() :
+	ticks(0) {
+	memset(&layout, 0, sizeof(layout));
+}
+
+/**
+ * Return icon showing the position of a window on the workspaces; icons
+ * are shared between all windows whose position scales to the same
+ * pixels; returns 0 if there's not enough space to display workspaces;
+ * the serial stays valid, see isValid(), as long as the icon exists
+ *
+ * @param base - icon of the window
+ * @param wsl - workspace layout
+ * @param x - horizontal position of window on all workspaces
+ * @param y - vertical position of window on all workspaces
+ * @param width - width of window
+ * @param height - height of window
+ * @param workspaceColor - ARGB value of workspace
+ * @param windowColor - ARGB value of window
+ * @param serial - serial of the returned icon
+ */
+Icon *WorkspaceIconMap::getIcon(
+		Icon *base,
+		WorkspaceLayout *wsl,
+		int x,
+		int y,
+		int width,
+		int height,
+		unsigned int workspaceColor,
+		unsigned int windowColor,
+		unsigned long &serial) {
+	// drop everything when the layout has changed
+	if (layout.screenWidth != wsl->getScreenWidth() ||
+			layout.screenHeight != wsl->getScreenHeight() ||
+			layout.totalWidth != wsl->getTotalWidth() ||
+			layout.totalHeight != wsl->getTotalHeight()) {
+		clear();
+
+		layout.screenWidth = wsl->getScreenWidth();
+		layout.screenHeight = wsl->getScreenHeight();
+		layout.totalWidth = wsl->getTotalWidth();
+		layout.totalHeight = wsl->getTotalHeight();
+	}
+
+	const ArgbSurface *s = &base->getSurface();
+	int paddingX = 0;
+	int paddingY = 0;
+	double f;
+
+	if (wsl->getTotalWidth() > wsl->getTotalHeight()) {
+		f = static_cast<double>(s->getWidth()) / wsl->getTotalWidth();
+		paddingY = (s->getHeight() -
+			static_cast<int>(f * wsl->getTotalHeight())) >> 1;
+	} else {
+		f = static_cast<double>(s->getHeight()) / wsl->getTotalHeight();
+		paddingX = (s->getWidth()-
+			static_cast<int>(f * wsl->getTotalWidth())) >> 1;
+	}
+
+	// there's not enough space to display workspaces
+	if (static_cast<int>(f*wsl->getScreenWidth()) < 2 ||
+			static_cast<int>(f*wsl->getScreenHeight()) < 2) {
+		return 0;
+	}
+
+	Key key;
+
+	memset(&key, 0, sizeof(key));
+	key.icon = base;
+	key.type = base->getType();
+	key.workspaceColor = workspaceColor;
+	key.windowColor = windowColor;
+
+	// scale window geometry into icon pixels; a window that extends
+	// beyond the last workspace is wrapped around to the first one
+	{
+		Geometry g = { x, y, width, height };
+		Geometry r = { x, y, 0, 0 };
+		const int totalWidth = static_cast<int>(wsl->getTotalWidth());
+		const int totalHeight = static_cast<int>(wsl->getTotalHeight());
+		int xe = g.x+g.width;
+		int ye = g.y+g.height;
+
+		if (xe > totalWidth) {
+			r.width = xe-totalWidth;
+			g.width = totalWidth-g.x;
+			r.x = 0;
+			r.height = g.height;
+		}
+
+		if (ye > totalHeight) {
+			r.height = ye-totalHeight;
+			g.height = totalHeight-g.y;
+			r.y = 0;
+			r.width = g.width;
+		}
+
+		for (int n = 0; ; ++n) {
+			int w = static_cast<int>(f*g.width);
+			int h = static_cast<int>(f*g.height);
+
+			key.windows[n].x = paddingX+static_cast<int>(f*g.x);
+			key.windows[n].y = paddingY+static_cast<int>(f*g.y);
+			key.windows[n].width = w < 1 ? 1 : w;
+			key.windows[n].height = h < 1 ? 1 : h;
+
+			if (r.width || r.height) {
+				g = r;
+				r.width = r.height = 0;
+				continue;
+			}
+
+			break;
+		}
+	}
+
+	// cache look up
+	{
+		KeyToEntry::iterator i;
+
+		if ((i = icons.find(key)) != icons.end()) {
+			(*i).second.used = ++ticks;
+			serial = (*i).second.serial;
+
+			return (*i).second.icon;
+		}
+	}
+
+	if (icons.size() >= MaximumIcons) {
+		evict();
+	}
+
+	const ArgbSurface *grid = getGrid(
+		s->getWidth(),
+		s->getHeight(),
+		workspaceColor,
+		f,
+		paddingX,
+		paddingY);
+	ArgbSurface t(*s);
+	Blender b(t);
+
+	b.blend(*grid, 0, 0);
+
+	for (int n = 0; n < 2 && key.windows[n].width; ++n) {
+		Cartouche window(
+			key.windows[n].width,
+			key.windows[n].height,
+			0,
+			windowColor);
+
+		b.blend(window, key.windows[n].x, key.windows[n].y);
+	}
+
+	Entry e = { new Icon(&t), ++ticks, ticks };
+	icons[key] = e;
+	serials.insert(e.serial);
+	serial = e.serial;
+
+	return e.icon;
+}
+
+/**
+ * Free all icons; serials are never handed out twice so menu items
+ * can tell if the icon they got is still valid
+ */
+void WorkspaceIconMap::clear() {
+	for (KeyToEntry::iterator i = icons.begin();
+			i != icons.end();
+			++i) {
+		delete (*i).second.icon;
+	}
+
+	icons.clear();
+	serials.clear();
+
+	for (KeyToGrid::iterator i = grids.begin();
+			i != grids.end();
+			++i) {
+		delete (*i).second;
+	}
+
+	grids.clear();
+}
+
+/**
+ * Take over all icons of some other map
+ *
+ * @param other - other map, loses its icons
+ */
+void WorkspaceIconMap::adopt(WorkspaceIconMap &other) {
+	clear();
+
+	layout = other.layout;
+	icons.swap(other.icons);
+	serials.swap(other.serials);
+	grids.swap(other.grids);
+
+	// keep serials of adopted icons unique
+	if (other.ticks > ticks) {
+		ticks = other.ticks;
+	}
+}
+
+/**
+ * Free the least recently used icon
+ */
+void WorkspaceIconMap::evict() {
+	KeyToEntry::iterator oldest = icons.begin();
+
+	for (KeyToEntry::iterator i = icons.begin();
+			i != icons.end();
+			++i) {
+		if ((*i).second.used < (*oldest).second.used) {
+			oldest = i;
+		}
+	}
+
+	if (oldest == icons.end()) {
+		return;
+	}
+
+	delete (*oldest).second.icon;
+	serials.erase((*oldest).second.serial);
+	icons.erase(oldest);
+}
+
+/**
+ * Return pre-rendered workspace grid for the current layout
+ *
+ * @param width - width of icon
+ * @param height - height of icon
+ * @param color - ARGB value of workspace
+ * @param f - scale factor
+ * @param paddingX - horizontal padding
+ * @param paddingY - vertical padding
+ */
+const ArgbSurface *WorkspaceIconMap::getGrid(
+		int width,
+		int height,
+		unsigned int color,
+		double f,
+		int paddingX,
+		int paddingY) {
+	GridKey key = { width, height, color };
+	KeyToGrid::iterator i;
+
+	if ((i = grids.find(key)) != grids.end()) {
+		return (*i).second;
+	}
+
+	ArgbSurface *s = new ArgbSurface(width, height);
+	int w = static_cast<int>(f*layout.screenWidth);
+	int h = static_cast<int>(f*layout.screenHeight);
+	int columns = layout.totalWidth / layout.screenWidth;
+	int rows = layout.totalHeight / layout.screenHeight;
+
+	memset(s->getData(), 0, s->getSize());
+
+	// copy the workspaces onto a transparent surface; they don't
+	// overlap so blending this surface gives the same result as
+	// blending every single workspace
+	{
+		Cartouche workspace(
+			w-1,
+			h-1,
+			0,
+			color);
+
+		for (int r = rows, y = paddingY;
+				r--;
+				y += h)
+			for (int c = columns, x = paddingX;
+					c--;
+					x += w) {
+				copy(*s, workspace, x, y);
+			}
+	}
+
+	grids[key] = s;
+
+	return s;
+}
+
+/**
+ * Copy surface into another surface without blending
+ *
+ * @param dest - destination surface
+ * @param src - source surface
+ * @param x - left position in destination
+ * @param y - upper position in destination
+ */
+void WorkspaceIconMap::copy(
+		ArgbSurface &dest,
+		const ArgbSurface &src,
+		int x,
+		int y) {
+	int left = x < 0 ? -x : 0;
+	int top = y < 0 ? -y : 0;
+	int width = src.getWidth();
+	int height = src.getHeight();
+
+	if (x + width > dest.getWidth()) {
+		width = dest.getWidth() - x;
+	}
+
+	if (y + height > dest.getHeight()) {
+		height = dest.getHeight() - y;
+	}
+
+	if ((width -= left) < 1) {
+		return;
+	}
+
+	for (int row = top; row < height; ++row) {
+		memcpy(
+			dest.getData() +
+				(y + row) * dest.getBytesPerLine() +
+				((x + left) << 2),
+			src.getData() +
+				row * src.getBytesPerLine() +
+				(left << 2),
+			width << 2);
+	}
+}
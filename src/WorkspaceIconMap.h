@@ -0,0 +1,87 @@
+#ifndef _PieDock_WorkspaceIconMap_
+#define _PieDock_WorkspaceIconMap_
+
+#include "Icon.h"
+#include "WorkspaceLayout.h"
+
+#include <map>
+#include <set>
+
+namespace PieDock {
+class WorkspaceIconMap {
+public:
+	WorkspaceIconMap();
+	virtual ~WorkspaceIconMap() {
+		clear();
+	}
+	inline bool isValid(unsigned long serial) const {
+		return serials.find(serial) != serials.end();
+	}
+	virtual Icon *getIcon(Icon *, WorkspaceLayout *,
+		int, int, int, int, unsigned int, unsigned int, unsigned long &);
+	virtual void clear();
+	virtual void adopt(WorkspaceIconMap &);
+
+protected:
+	typedef struct {
+		int x;
+		int y;
+		int width;
+		int height;
+	} Geometry;
+
+	virtual const ArgbSurface *getGrid(int, int, unsigned int,
+		double, int, int);
+	virtual void copy(ArgbSurface &, const ArgbSurface &, int, int);
+
+private:
+	enum {
+		MaximumIcons = 256
+	};
+
+	typedef struct Layout {
+		unsigned long screenWidth;
+		unsigned long screenHeight;
+		unsigned long totalWidth;
+		unsigned long totalHeight;
+	} Layout;
+
+	typedef struct Key {
+		Icon *icon;
+		Icon::Type type;
+		unsigned int workspaceColor;
+		unsigned int windowColor;
+		Geometry windows[2];
+
+		bool operator<(const Key &) const;
+	} Key;
+
+	typedef struct GridKey {
+		int width;
+		int height;
+		unsigned int color;
+
+		bool operator<(const GridKey &) const;
+	} GridKey;
+
+	typedef struct Entry {
+		Icon *icon;
+		unsigned long serial;
+		unsigned long used;
+	} Entry;
+
+	typedef std::map<Key, Entry> KeyToEntry;
+	typedef std::set<unsigned long> Serials;
+	typedef std::map<GridKey, ArgbSurface *> KeyToGrid;
+
+	unsigned long ticks;
+	Layout layout;
+	KeyToEntry icons;
+	Serials serials;
+	KeyToGrid grids;
+
+	void evict();
+};
+}
+
+#endif
@@ -25,6 +25,21 @@ WorkspaceLayout *WorkspaceLayout::getWorkspaceLayout(
 	return (singleton = new WorkspaceLayout(d, l));
 }
 
+/**
+ * Change preferred layout of workspaces
+ *
+ * @param l - preferred layout of workspaces
+ */
+void WorkspaceLayout::setPreferredLayout(PreferredVirtualLayout l) {
+	if (l == preferredLayout) {
+		return;
+	}
+
+	preferredLayout = l;
+	updateGeometry();
+	++serial;
+}
+
 /**
  * Returns true if the given window is on another workspace
  *
@@ -36,6 +51,8 @@ bool WorkspaceLayout::isOnAnotherWorkspace(
 		WorkspacePosition &p) {
 	XWindowAttributes wa;
 
+	RequestCounter::roundTrip();
+
 	if (XGetWindowAttributes(display, w, &wa)) {
 		return isOnAnotherWorkspace(w, wa, p);
 	}
@@ -58,6 +75,7 @@ bool WorkspaceLayout::isOnAnotherWorkspace(
 	{
 		Window dummy;
 
+		RequestCounter::roundTrip();
 		XTranslateCoordinates(
 			display,
 			w,
@@ -70,27 +88,21 @@ bool WorkspaceLayout::isOnAnotherWorkspace(
 	}
 
 	if (virtualDesktop) {
-		unsigned long vx;
-		unsigned long vy;
-
 		if ((p.x < 0 ||
 				p.y < 0 ||
 				p.x > screen.width ||
 				p.y > screen.height) &&
-				WindowManager::getWorkspacePosition(
-					display,
-					vx,
-					vy)) {
-			if (p.x < 0 && !vx) {
+				hasViewport) {
+			if (p.x < 0 && !viewportX) {
 				p.x += total.width;
 			} else {
-				p.x += vx;
+				p.x += viewportX;
 			}
 
-			if (p.y < 0 && !vy) {
+			if (p.y < 0 && !viewportY) {
 				p.y += total.height;
 			} else {
-				p.y += vy;
+				p.y += viewportY;
 			}
 
 			return true;
@@ -98,7 +110,7 @@ bool WorkspaceLayout::isOnAnotherWorkspace(
 	} else {
 		p.number = WindowManager::getWorkspace(display, w);
 
-		if (p.number != WindowManager::getCurrentWorkspace(display)) {
+		if (p.number != currentWorkspace) {
 			switch (preferredLayout) {
 			case Horizontal:
 				p.x += p.number*screen.width;
@@ -120,6 +132,58 @@ bool WorkspaceLayout::isOnAnotherWorkspace(
 	return false;
 }
 
+/**
+ * Update layout from a PropertyNotify or ConfigureNotify event for the
+ * root window; returns true if the event has been consumed
+ *
+ * @param event - X event
+ */
+bool WorkspaceLayout::processEvent(XEvent &event) {
+	Window root = DefaultRootWindow(display);
+
+	if (event.xany.window != root) {
+		return false;
+	}
+
+	switch (event.type) {
+	case ConfigureNotify:
+		// screen resolution has changed
+		if (event.xconfigure.window != root) {
+			return false;
+		}
+
+		updateScreen();
+		updateGeometry();
+		++serial;
+		return true;
+	case PropertyNotify:
+		break;
+	default:
+		return false;
+	}
+
+	Atom a = event.xproperty.atom;
+
+	if (a == WindowManager::getAtom(display, "_NET_CURRENT_DESKTOP")) {
+		currentWorkspace = WindowManager::getCurrentWorkspace(display);
+	} else if (a == WindowManager::getAtom(display, "_NET_DESKTOP_VIEWPORT")) {
+		hasViewport = WindowManager::getWorkspacePosition(
+			display,
+			viewportX,
+			viewportY);
+	} else if (
+			a == WindowManager::getAtom(display, "_NET_NUMBER_OF_DESKTOPS") ||
+			a == WindowManager::getAtom(display, "_NET_DESKTOP_GEOMETRY")) {
+		updateGeometry();
+	} else {
+		return false;
+	}
+
+	++serial;
+
+	return true;
+}
+
 /**
  * Initialize workspace geometry info
  *
@@ -130,58 +194,74 @@ WorkspaceLayout::WorkspaceLayout(
 		Display *d,
 		PreferredVirtualLayout l) :
 	display(d),
-	preferredLayout(l) {
-	Window root = DefaultRootWindow(d);
+	preferredLayout(l),
+	serial(0) {
+	updateScreen();
+	updateGeometry();
 
+	currentWorkspace = WindowManager::getCurrentWorkspace(d);
+	hasViewport = WindowManager::getWorkspacePosition(
+		d,
+		viewportX,
+		viewportY);
+}
+
+/**
+ * Get screen geometry
+ */
+void WorkspaceLayout::updateScreen() {
 	// get desktop geometry, can't use _NET_WORKAREA here because
 	// it returns the geometry minus dock windows; nor does
 	// _NET_DESKTOP_GEOMETRY fit because it returns the dimensions
 	// of the large desktop
-	{
-		XWindowAttributes xwa;
+	XWindowAttributes xwa;
 
-		if (!XGetWindowAttributes(d, root, &xwa)) {
-			throw std::runtime_error("cannot get attributes of root window");
-		}
+	RequestCounter::roundTrip();
 
-		screen.width = xwa.width;
-		screen.height = xwa.height;
+	if (!XGetWindowAttributes(display, DefaultRootWindow(display), &xwa)) {
+		throw std::runtime_error("cannot get attributes of root window");
 	}
 
-	// get total size of all workspaces
-	{
-		unsigned long n;
+	screen.width = xwa.width;
+	screen.height = xwa.height;
+}
 
-		if ((n = WindowManager::getNumberOfWorkspaces(d)) > 1) {
-			switch (l) {
-			case Horizontal:
-				total.width = n * screen.width;
-				total.height = screen.height;
-				break;
-			case Vertical:
-				total.width = screen.width;
-				total.height = n * screen.height;
-				break;
-			default:
-			case Square:
-				int s = static_cast<int>(ceil(sqrt(n)));
-				total.width = s * screen.width;
-				total.height = s * screen.height;
-				break;
-			}
+/**
+ * Get total size of all workspaces
+ */
+void WorkspaceLayout::updateGeometry() {
+	if ((numberOfWorkspaces =
+			WindowManager::getNumberOfWorkspaces(display)) > 1) {
+		unsigned long n = numberOfWorkspaces;
 
-			virtualDesktop = false;
-		} else {
-			if (!WindowManager::getDesktopGeometry(
-					d,
-					total.width,
-					total.height)) {
-				total.width = screen.width;
-				total.height = screen.height;
-			}
+		switch (preferredLayout) {
+		case Horizontal:
+			total.width = n * screen.width;
+			total.height = screen.height;
+			break;
+		case Vertical:
+			total.width = screen.width;
+			total.height = n * screen.height;
+			break;
+		default:
+		case Square:
+			int s = static_cast<int>(ceil(sqrt(n)));
+			total.width = s * screen.width;
+			total.height = s * screen.height;
+			break;
+		}
 
-			virtualDesktop = true;
+		virtualDesktop = false;
+	} else {
+		if (!WindowManager::getDesktopGeometry(
+				display,
+				total.width,
+				total.height)) {
+			total.width = screen.width;
+			total.height = screen.height;
 		}
+
+		virtualDesktop = true;
 	}
 
 	columns = total.width / screen.width;
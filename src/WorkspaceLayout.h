@@ -40,11 +40,19 @@ public:
 	inline const bool &isVirtual() const {
 		return virtualDesktop;
 	}
+	inline const unsigned long &getCurrentWorkspace() const {
+		return currentWorkspace;
+	}
+	inline const unsigned long &getSerial() const {
+		return serial;
+	}
 	static WorkspaceLayout *getWorkspaceLayout(Display *,
 			PreferredVirtualLayout = Horizontal);
+	void setPreferredLayout(PreferredVirtualLayout);
 	bool isOnAnotherWorkspace(Window, WorkspacePosition &);
 	bool isOnAnotherWorkspace(Window, XWindowAttributes &,
 			WorkspacePosition &);
+	bool processEvent(XEvent &);
 
 private:
 	typedef struct {
@@ -60,8 +68,16 @@ private:
 	int columns;
 	int rows;
 	bool virtualDesktop;
+	unsigned long numberOfWorkspaces;
+	unsigned long currentWorkspace;
+	unsigned long viewportX;
+	unsigned long viewportY;
+	bool hasViewport;
+	unsigned long serial;
 
 	WorkspaceLayout(Display *, PreferredVirtualLayout);
+	void updateScreen();
+	void updateGeometry();
 	WorkspaceLayout &operator=(const WorkspaceLayout &) {
 		return *this;
 	}
@@ -3,11 +3,12 @@
 #endif
 
 #include "Application.h"
+#include "ControlClient.h"
+#include "Timings.h"
+#include "Bench.h"
 
-#include <sys/wait.h>
 #include <sys/types.h>
 #include <unistd.h>
-#include <signal.h>
 #include <libgen.h>
 #include <stdlib.h>
 
@@ -18,29 +19,6 @@
 #include <iostream>
 #include <stdexcept>
 
-bool stop = false;
-
-/**
- * Signal handler
- *
- * @param id - signal id
- */
-void signalHandler(int id) {
-	switch (id) {
-	case SIGCHLD:
-		// more than one process may have been terminated
-		while (waitpid(-1, 0, WNOHANG | WUNTRACED) > 0);
-		break;
-	case SIGHUP:
-	case SIGINT:
-	case SIGTERM:
-		stop = true;
-		break;
-	}
-
-	return;
-}
-
 /**
  * Process entry
  *
@@ -51,6 +29,12 @@ int main(int argc, char **argv) {
 	try {
 		PieDock::Settings settings;
 		char *menuName = 0;
+		char *timingsFile = 0;
+		char *traceFile = 0;
+		bool metrics = false;
+		int benchDepth = 0;
+		char *benchDirectory = 0;
+		std::string commands;
 
 		// parse arguments
 		{
@@ -66,13 +50,26 @@ int main(int argc, char **argv) {
 					case '?':
 					case 'h':
 						std::cout <<
-							binary << " [hvrm]" << std::endl <<
+							binary << " [hvrmcstjbo]" << std::endl <<
 							"\t-h         this help" << std::endl <<
 							"\t-v         show version" << std::endl <<
 							"\t-r FILE    path and name of alternative " <<
 							"configuration file" << std::endl <<
 							"\t-m [MENU]  show already running " <<
-							"instance" << std::endl;
+							"instance" << std::endl <<
+							"\t-c COMMAND send command to already " <<
+							"running instance and print reply" << std::endl <<
+							"\t-s         print cache and memory " <<
+							"statistics of running instance" << std::endl <<
+							"\t-t FILE    write latency histograms to " <<
+							"FILE at exit" << std::endl <<
+							"\t-j FILE    write Chrome trace events " <<
+							"to FILE" << std::endl <<
+							"\t-b DEPTH   draw a synthetic menu into " <<
+							"memory of DEPTH bits per pixel and " <<
+							"print timings" << std::endl <<
+							"\t-o DIR     write frames of -b as PNG " <<
+							"into DIR" << std::endl;
 						return 0;
 					case 'v':
 						std::cout <<
@@ -107,6 +104,52 @@ int main(int argc, char **argv) {
 						}
 						settings.setConfigurationFile(*++argv);
 						break;
+					case 'c':
+						if (!--argc) {
+							throw std::invalid_argument(
+								"missing COMMAND argument");
+						}
+						commands += *++argv;
+						commands += PieDock::ControlClient::StopMarker;
+						break;
+					case 's':
+						metrics = true;
+						break;
+					case 't':
+						if (!--argc) {
+							throw std::invalid_argument(
+								"missing FILE argument");
+						}
+						timingsFile = *++argv;
+						break;
+					case 'j':
+						if (!--argc) {
+							throw std::invalid_argument(
+								"missing FILE argument");
+						}
+						traceFile = *++argv;
+						break;
+					case 'b':
+						if (!--argc) {
+							throw std::invalid_argument(
+								"missing DEPTH argument");
+						}
+						benchDepth = atoi(*++argv);
+
+						if (benchDepth != 16 &&
+								benchDepth != 24 &&
+								benchDepth != 32) {
+							throw std::invalid_argument(
+								"DEPTH must be 16, 24 or 32");
+						}
+						break;
+					case 'o':
+						if (!--argc) {
+							throw std::invalid_argument(
+								"missing DIR argument");
+						}
+						benchDirectory = *++argv;
+						break;
 					case 'm':
 						if (argc > 1 && **(argv+1) != '-') {
 							--argc;
@@ -125,6 +168,74 @@ int main(int argc, char **argv) {
 			}
 		}
 
+		// runs without display and without reading the
+		// configuration file to get comparable results
+		if (benchDepth) {
+			PieDock::Settings defaults;
+
+			if (traceFile) {
+				PieDock::Trace::open(traceFile);
+			}
+
+			PieDock::Bench(defaults, benchDepth).run(
+				std::cout,
+				benchDirectory ? benchDirectory : "");
+
+			PieDock::Trace::close();
+
+			if (timingsFile) {
+				PieDock::Timings::dump(timingsFile);
+			}
+
+			return 0;
+		}
+
+		if (metrics) {
+			std::string reply;
+
+			if (!PieDock::ControlClient(
+					settings.getConfigurationFile()).request(
+						"metrics",
+						reply)) {
+				throw std::runtime_error("no running instance");
+			}
+
+			// strip status line to leave plain exposition format
+			std::string::size_type p = reply.rfind('\n', reply.size() - 2);
+
+			if (reply.compare(p + 1, std::string::npos, "ok\n")) {
+				throw std::runtime_error(reply);
+			}
+
+			std::cout << reply.substr(0, p + 1);
+
+			return 0;
+		}
+
+		if (!commands.empty()) {
+			std::string reply;
+
+			if (!PieDock::ControlClient(
+					settings.getConfigurationFile()).request(
+						commands,
+						reply)) {
+				throw std::runtime_error("no running instance");
+			}
+
+			std::cout << reply;
+
+			return (reply.compare(0, 5, "error") &&
+				reply.find("\nerror") == std::string::npos) ? 0 : 1;
+		}
+
+		// if another instance is already running, wake it before
+		// doing anything expensive like forking or initializing
+		// X and toolkits
+		if (PieDock::ControlClient(
+				settings.getConfigurationFile()).show(menuName)) {
+			return 0;
+		}
+
 		switch (fork()) {
 		default:
 			// terminate parent process to detach from shell
@@ -147,7 +258,7 @@ int main(int argc, char **argv) {
 		// always open display after fork
 		PieDock::Application a(settings);
 
-		// if another instance is already running, wake it
+		// another instance may have started in the meantime
 		if (a.remote(menuName)) {
 			return 0;
 		}
@@ -155,18 +266,23 @@ int main(int argc, char **argv) {
 		// obtain new process group
 		setsid();
 
-		signal(SIGCHLD, signalHandler);
-		signal(SIGHUP, signalHandler);
-		signal(SIGINT, signalHandler);
-		signal(SIGTERM, signalHandler);
+		if (traceFile) {
+			PieDock::Trace::open(traceFile);
+		}
+
+		int r = a.run();
 
 #ifdef HAVE_KDE
-		int r = a.run(&stop);
 		q.quit();
-		return r;
-#else
-		return a.run(&stop);
 #endif
+
+		PieDock::Trace::close();
+
+		if (timingsFile) {
+			PieDock::Timings::dump(timingsFile);
+		}
+
+		return r;
 	} catch (std::exception &e) {
 		std::cerr << "error: " << e.what() << std::endl;
 